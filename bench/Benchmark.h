@@ -0,0 +1,203 @@
+#pragma once
+
+// Mini framework de microbenchmarks al estilo de Google Benchmark:
+//
+//   static void BM_Algo(BenchState& state) {
+//       for (auto _ : state) { ...código a medir... }
+//       state.setItemsProcessed(state.iterations() * N);
+//   }
+//   BENCHMARK(BM_Algo)->Range(8, 512);
+//
+// Cada caso se repite hasta cubrir un tiempo mínimo y se reporta ns/op,
+// asignaciones de heap por op y throughput (bytes/s o items/s).
+
+#include "../src/AllocationCounter.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Asignaciones de heap contadas por el operator new de src/AllocationCounter.cpp
+inline uint64_t allocationCount() {
+    return AllocationCounter::total();
+}
+
+// Evita que el compilador elimine un resultado que no se usa
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+class BenchState {
+public:
+    BenchState(int64_t arg, uint64_t iterations) : argument(arg), maxIterations(iterations) {}
+
+    int64_t range() const { return argument; }
+    uint64_t iterations() const { return maxIterations; }
+
+    void setBytesProcessed(uint64_t bytes) { bytesProcessed = bytes; }
+    void setItemsProcessed(uint64_t items) { itemsProcessed = items; }
+    void skip(const char* reason) { skipReason = reason; }
+
+    // Pausa el cronómetro para preparar datos dentro del loop
+    void pauseTiming() {
+        pausedAt = Clock::now();
+        pausedAllocs = allocationCount();
+    }
+    void resumeTiming() {
+        pausedTime += Clock::now() - pausedAt;
+        pausedAllocCount += allocationCount() - pausedAllocs;
+    }
+
+    // Iterador para "for (auto _ : state)": arranca el cronómetro al empezar y lo para al terminar
+    struct Iterator {
+        BenchState* state;
+        uint64_t remaining;
+        bool operator!=(const Iterator&) const {
+            if (remaining != 0) return true;
+            state->stop();
+            return false;
+        }
+        void operator++() { --remaining; }
+        // Constructor y destructor propios (como en Google Benchmark): así '_' no cuenta como
+        // variable sin usar con -Wall
+        struct Value { Value() {} ~Value() {} };
+        Value operator*() const { return Value(); }
+    };
+    Iterator begin() { start(); return Iterator{ this, maxIterations }; }
+    Iterator end() { return Iterator{ this, 0 }; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    friend struct Runner;
+
+    int64_t argument;
+    uint64_t maxIterations;
+    uint64_t bytesProcessed = 0;
+    uint64_t itemsProcessed = 0;
+    const char* skipReason = nullptr;
+
+    Clock::time_point startedAt, pausedAt;
+    Clock::duration pausedTime{};
+    Clock::duration elapsed{};
+    uint64_t startAllocs = 0, pausedAllocs = 0, pausedAllocCount = 0, allocs = 0;
+
+    void start() {
+        pausedTime = Clock::duration{};
+        pausedAllocCount = 0;
+        startAllocs = allocationCount();
+        startedAt = Clock::now();
+    }
+    void stop() {
+        elapsed = Clock::now() - startedAt - pausedTime;
+        allocs = allocationCount() - startAllocs - pausedAllocCount;
+    }
+};
+
+using BenchFunction = void (*)(BenchState&);
+
+struct Benchmark {
+    std::string name;
+    BenchFunction function;
+    std::vector<int64_t> args;
+
+    // Potencias de 2 entre lo y hi (inclusive), como Range() de Google Benchmark
+    Benchmark* Range(int64_t lo, int64_t hi) {
+        for (int64_t a = lo; a < hi; a *= 2)
+            args.push_back(a);
+        args.push_back(hi);
+        return this;
+    }
+    Benchmark* Arg(int64_t a) {
+        args.push_back(a);
+        return this;
+    }
+};
+
+inline std::vector<Benchmark*>& registry() {
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+inline Benchmark* registerBenchmark(const char* name, BenchFunction function) {
+    Benchmark* b = new Benchmark{ name, function, {} };
+    registry().push_back(b);
+    return b;
+}
+
+struct Runner {
+    double minSeconds = 0.25;
+    std::string filter;
+
+    static std::string formatRate(double perSecond, const char* unit) {
+        const char* prefixes[] = { "", "k", "M", "G" };
+        int p = 0;
+        while (perSecond >= 1000.0 && p < 3) { perSecond /= 1000.0; p++; }
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.2f %s%s/s", perSecond, prefixes[p], unit);
+        return buf;
+    }
+
+    void runOne(const Benchmark& b, int64_t arg, bool hasArg) {
+        std::string name = b.name;
+        if (hasArg) name += "/" + std::to_string(arg);
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+
+        // Crecemos el número de iteraciones hasta que la medición dure lo suficiente
+        uint64_t iterations = 1;
+        for (;;) {
+            BenchState state(arg, iterations);
+            b.function(state);
+            if (state.skipReason) {
+                std::printf("%-44s %s\n", name.c_str(), state.skipReason);
+                return;
+            }
+            double seconds = std::chrono::duration<double>(state.elapsed).count();
+            if (seconds >= minSeconds || iterations >= (1ull << 30)) {
+                double nsPerOp = seconds * 1e9 / iterations;
+                double allocsPerOp = (double)state.allocs / iterations;
+                std::string throughput;
+                if (state.bytesProcessed)
+                    throughput = formatRate(state.bytesProcessed / seconds, "B");
+                else if (state.itemsProcessed)
+                    throughput = formatRate(state.itemsProcessed / seconds, "items");
+                std::printf("%-44s %12llu %14.1f %12.2f   %s\n", name.c_str(),
+                            (unsigned long long)iterations, nsPerOp, allocsPerOp, throughput.c_str());
+                return;
+            }
+            // Estimación de cuántas iteraciones faltan (con margen), como mínimo x2
+            double scale = seconds > 0.0 ? (minSeconds * 1.4) / seconds : 100.0;
+            uint64_t next = (uint64_t)(iterations * (scale > 100.0 ? 100.0 : scale));
+            iterations = next > iterations * 2 ? next : iterations * 2;
+        }
+    }
+
+    void runAll() {
+        std::printf("%-44s %12s %14s %12s   %s\n", "Benchmark", "Iteraciones", "ns/op", "allocs/op", "Throughput");
+        std::printf("%s\n", std::string(100, '-').c_str());
+        for (const Benchmark* b : registry()) {
+            if (b->args.empty())
+                runOne(*b, 0, false);
+            for (int64_t a : b->args)
+                runOne(*b, a, true);
+        }
+    }
+};
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(fn) \
+    static bench::Benchmark* BENCH_CONCAT(bench_registration_, __LINE__) = bench::registerBenchmark(#fn, fn)
@@ -0,0 +1,640 @@
+// Microbenchmarks de los caminos calientes de CPU del motor.
+//
+// Uso: bench.exe [--filter texto] [--min-time segundos] [--gpu]
+//   --gpu crea una ventana oculta con contexto OpenGL para los casos que lo necesitan
+//   (setters de Shader); sin esa opción esos casos se omiten.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "Benchmark.h"
+
+#include "../src/AnimationClip.h"
+#include "../src/AnimationScheduler.h"
+#include "../src/Bezier.h"
+#include "../src/Components.h"
+#include "../src/FrameArena.h"
+#include "../src/Grass.h"
+#include "../src/LightClusters.h"
+#include "../src/Model.h"
+#include "../src/OcclusionCulling.h"
+#include "../src/ParticleSystem.h"
+#include "../src/ProjectilePool.h"
+#include "../src/Registry.h"
+#include "../src/RenderGraph.h"
+#include "../src/SceneGraph.h"
+#include "../src/Shader.h"
+#include "../src/ShaderPermutations.h"
+#include "../src/Sphere.h"
+#include "../src/StreamBuffer.h"
+#include "../src/UniformBlocks.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+// Shader y StreamBuffer de prueba para los casos con GPU (nullptr si no hay contexto)
+static Shader* gpuShader = nullptr;
+static StreamBuffer* gpuStream = nullptr;
+
+// --- Model::processMesh (parte de geometría) ---
+// Malla sintética en forma de rejilla con N vértices, como las que entrega Assimp
+static aiMesh* makeGridMesh(unsigned int vertexCount) {
+    unsigned int side = 2;
+    while (side * side < vertexCount) side++;
+
+    aiMesh* mesh = new aiMesh();
+    mesh->mNumVertices = side * side;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    for (unsigned int y = 0; y < side; y++) {
+        for (unsigned int x = 0; x < side; x++) {
+            unsigned int i = y * side + x;
+            mesh->mVertices[i] = aiVector3D((float)x, 0.0f, (float)y);
+            mesh->mNormals[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+            mesh->mTextureCoords[0][i] = aiVector3D((float)x / side, (float)y / side, 0.0f);
+        }
+    }
+
+    mesh->mNumFaces = (side - 1) * (side - 1) * 2;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    unsigned int f = 0;
+    for (unsigned int y = 0; y + 1 < side; y++) {
+        for (unsigned int x = 0; x + 1 < side; x++) {
+            unsigned int i0 = y * side + x, i1 = i0 + 1, i2 = i0 + side, i3 = i2 + 1;
+            unsigned int tris[2][3] = { { i0, i2, i1 }, { i1, i2, i3 } };
+            for (auto& tri : tris) {
+                aiFace& face = mesh->mFaces[f++];
+                face.mNumIndices = 3;
+                face.mIndices = new unsigned int[3] { tri[0], tri[1], tri[2] };
+            }
+        }
+    }
+    return mesh;
+}
+
+static void BM_ProcessMeshGeometry(bench::BenchState& state) {
+    aiMesh* mesh = makeGridMesh((unsigned int)state.range());
+    for (auto _ : state) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        Model::extractGeometry(mesh, vertices, indices);
+        bench::doNotOptimize(vertices.data());
+        bench::doNotOptimize(indices.data());
+    }
+    state.setItemsProcessed(state.iterations() * mesh->mNumVertices);
+    delete mesh;
+}
+BENCHMARK(BM_ProcessMeshGeometry)->Range(1 << 10, 1 << 18);
+
+// --- Sphere::buildVerticesSmooth ---
+// El argumento es el número de sectores; los stacks son la mitad (como el cielo: 32x32 / energía: 24x24)
+static void BM_SphereBuildVertices(bench::BenchState& state) {
+    int sectors = (int)state.range();
+    int stacks = sectors / 2 > 2 ? sectors / 2 : 2;
+    for (auto _ : state) {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        Sphere::buildVerticesSmooth(1.0f, sectors, stacks, vertices, indices);
+        bench::doNotOptimize(vertices.data());
+        bench::doNotOptimize(indices.data());
+    }
+    state.setItemsProcessed(state.iterations() * (uint64_t)(sectors + 1) * (stacks + 1));
+}
+BENCHMARK(BM_SphereBuildVertices)->Range(8, 512);
+
+// --- calculateBezier ---
+// El argumento es cuántos puntos de la curva se evalúan por op
+static void BM_CalculateBezier(bench::BenchState& state) {
+    int count = (int)state.range();
+    glm::vec3 p0(0.0f, 1.5f, 0.0f), p1(0.0f, 4.5f, 0.0f), p2(0.0f, 2.5f, 10.0f), p3(0.0f, 0.5f, 10.0f);
+    float step = 1.0f / count;
+    for (auto _ : state) {
+        glm::vec3 acc(0.0f);
+        for (int i = 0; i < count; i++)
+            acc += calculateBezier(i * step, p0, p1, p2, p3);
+        bench::doNotOptimize(acc);
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CalculateBezier)->Range(1, 4096);
+
+// --- ProjectilePool::update (tabla de arco + calculateBezierBatch) ---
+// El argumento es cuántos proyectiles vivos hay; se relanzan los que terminan
+static void BM_ProjectileUpdate(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    ProjectilePool pool(count);
+    glm::vec3 p0(0.0f, 1.5f, 0.0f), p1(0.0f, 4.5f, 0.0f), p2(0.0f, 2.5f, 10.0f), p3(0.0f, 0.5f, 10.0f);
+    for (size_t i = 0; i < count; i++)
+        pool.spawn(p0, p1, p2, p3 + glm::vec3((float)i * 0.01f, 0.0f, 0.0f), 1000.0f);
+    for (auto _ : state) {
+        pool.update(1.0f / 60.0f);
+        bench::doNotOptimize(pool.size());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ProjectileUpdate)->Range(64, 4096);
+
+// --- ParticleSystem::update (integración SIMD + compactación, un solo hilo) ---
+// El argumento es el número de partículas vivas
+static void BM_ParticleUpdate(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    ParticleSystem system(count);
+    ParticleEmitter e;
+    e.speed = 3.0f;
+    e.lifetime = 1e6f; // Que no muera ninguna durante la medición
+    e.lift = -9.8f;
+    system.burst(e, (unsigned int)count);
+    for (auto _ : state) {
+        system.update(1.0f / 60.0f, nullptr);
+        bench::doNotOptimize(system.size());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParticleUpdate)->Range(1 << 10, 1 << 18);
+
+// --- Compresión y muestreo de clips de animación ---
+// Clip sintético de 2 s a 30 fps: el argumento es el número de pistas (huesos). Un tercio
+// se mueve todo el tiempo, un tercio gira a velocidad constante y el resto queda quieto.
+static RawAnimationClip makeRawClip(size_t trackCount) {
+    RawAnimationClip clip;
+    clip.name = "sintetico";
+    clip.frameCount = 61;
+    clip.tracks.resize(trackCount);
+    for (size_t t = 0; t < trackCount; t++) {
+        RawAnimationTrack& track = clip.tracks[t];
+        track.frames.resize(clip.frameCount);
+        for (uint32_t f = 0; f < clip.frameCount; f++) {
+            float x = f / 30.0f + (float)t;
+            AnimationPose& pose = track.frames[f];
+            if (t % 3 == 0) {
+                pose.translation = glm::vec3(std::sin(x * 3.0f), std::cos(x * 2.0f), 0.0f) * 5.0f;
+                pose.rotation = glm::angleAxis(std::sin(x) * 1.5f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+            } else if (t % 3 == 1) {
+                pose.rotation = glm::angleAxis(x * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+        }
+        clip.sourceBytes += clip.frameCount * (2 * sizeof(aiVectorKey) + sizeof(aiQuatKey));
+    }
+    return clip;
+}
+
+static void BM_AnimationCompress(bench::BenchState& state) {
+    RawAnimationClip raw = makeRawClip((size_t)state.range());
+    for (auto _ : state) {
+        CompressedAnimationClip clip = CompressedAnimationClip::compress(raw);
+        bench::doNotOptimize(clip.keys.size());
+    }
+    state.setItemsProcessed(state.iterations() * raw.tracks.size());
+}
+BENCHMARK(BM_AnimationCompress)->Range(16, 256);
+
+// Todas las pistas en un instante, como lo haría la actualización de un personaje
+static void BM_AnimationSample(bench::BenchState& state) {
+    CompressedAnimationClip clip = CompressedAnimationClip::compress(makeRawClip((size_t)state.range()));
+    std::vector<AnimationPose> poses(clip.tracks.size());
+    float time = 0.0f;
+    for (auto _ : state) {
+        time += 1.0f / 60.0f;
+        clip.sample(time, poses.data());
+        bench::doNotOptimize(poses[0].translation.x);
+    }
+    state.setItemsProcessed(state.iterations() * clip.tracks.size());
+}
+BENCHMARK(BM_AnimationSample)->Range(16, 256);
+
+// --- AnimationScheduler::update ---
+// Personajes con un clip de 64 pistas repartidos en una rejilla de 200x200 alrededor de la
+// cámara (una parte queda detrás o lejos). Sin workers, para medir sólo el costo por tick.
+// El argumento es el número de personajes; items = personajes, no poses evaluadas.
+static void BM_AnimationScheduler(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    CompressedAnimationClip clip = CompressedAnimationClip::compress(makeRawClip(64));
+    Registry registry;
+    registry.reserve(count);
+    registry.pool<Transform>().reserve(count);
+    registry.pool<Animator>().reserve(count);
+    size_t side = (size_t)std::ceil(std::sqrt((double)count));
+    for (size_t i = 0; i < count; i++) {
+        Entity e = registry.create();
+        Transform transform;
+        transform.position = glm::vec3((float)(i % side) / side * 200.0f - 100.0f, 0.0f, (float)(i / side) / side * 200.0f - 100.0f);
+        registry.add<Transform>(e, transform);
+        Animator animator;
+        animator.setClip(&clip);
+        registry.add<Animator>(e, std::move(animator));
+    }
+    AnimationScheduler scheduler;
+    scheduler.reserve(count);
+    glm::vec3 cameraPos(0.0f, 2.0f, 0.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f, 1.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    for (auto _ : state) {
+        scheduler.update(registry, 1.0f / 60.0f, cameraPos, projection, projection * view, nullptr);
+        bench::doNotOptimize(scheduler.updatedLastTick());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AnimationScheduler)->Range(64, 1 << 14);
+
+// --- OcclusionBuffer ---
+// Una ciudad de edificios (cajas) en una rejilla delante de la cámara. Rasterize: el
+// argumento es el número de edificios (sin workers, un solo hilo). IsVisible: 4096 cajas
+// de personaje repartidas detrás de 64 edificios; items = cajas probadas.
+static void buildOcclusionCity(OcclusionBuffer& buffer, const OccluderMesh& building, size_t count) {
+    glm::vec3 cameraPos(0.0f, 2.0f, 0.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 2.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f, 2.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    buffer.beginFrame(projection * view);
+    size_t side = (size_t)std::ceil(std::sqrt((double)count));
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 position((float)(i % side) * 12.0f - side * 6.0f, 0.0f, -10.0f - (float)(i / side) * 12.0f);
+        buffer.addOccluder(building, glm::translate(glm::mat4(1.0f), position));
+    }
+}
+
+static void BM_OcclusionRasterize(bench::BenchState& state) {
+    OcclusionBuffer buffer(256, 128);
+    OccluderMesh building = OccluderMesh::box(glm::vec3(4.0f, 6.0f, 4.0f));
+    for (auto _ : state) {
+        buildOcclusionCity(buffer, building, (size_t)state.range());
+        buffer.rasterize(nullptr);
+        bench::doNotOptimize(buffer.depthAt(128, 64));
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+BENCHMARK(BM_OcclusionRasterize)->Range(4, 256);
+
+static void BM_OcclusionIsVisible(bench::BenchState& state) {
+    OcclusionBuffer buffer(256, 128);
+    OccluderMesh building = OccluderMesh::box(glm::vec3(4.0f, 6.0f, 4.0f));
+    buildOcclusionCity(buffer, building, 64);
+    buffer.rasterize(nullptr);
+    const size_t boxes = 4096;
+    size_t visible = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < boxes; i++) {
+            glm::vec3 p((float)(i % 64) * 1.5f - 48.0f, 0.0f, -12.0f - (float)(i / 64) * 1.5f);
+            visible += buffer.isVisible(p - glm::vec3(0.5f, 0.0f, 0.5f), p + glm::vec3(0.5f, 1.8f, 0.5f));
+        }
+    }
+    bench::doNotOptimize(visible);
+    state.setItemsProcessed(state.iterations() * boxes);
+}
+BENCHMARK(BM_OcclusionIsVisible);
+
+// --- FrameArena ---
+// Lista temporal de un frame con FrameVector dentro de un ArenaScope (como la de cada
+// rebanada en LightClusterBuilder); el argumento es el número de elementos. Antes de medir
+// se comprueba la arena: asignar, beginFrame, desborde al heap y el adaptador STL sin
+// tocar el heap. Si algo falla el caso se marca como error en vez de medir.
+static const size_t BENCH_ARENA_BYTES = 1 << 20;
+
+static const char* checkFrameArena() {
+    LinearArena* arena = FrameArena::current();
+    if (!arena)
+        return "ERROR: el hilo del bench no tiene sub-arena";
+    FrameArena::beginFrame();
+    void* first = FrameArena::allocate(100, 16);
+    void* second = FrameArena::allocate(8, 64);
+    if (!arena->owns(first) || !arena->owns(second) || ((uintptr_t)second & 63) != 0 || arena->used() < 108)
+        return "ERROR: allocate no toma memoria alineada de la arena";
+    FrameArena::beginFrame();
+    if (arena->used() != 0 || FrameArena::allocate(100, 16) != first)
+        return "ERROR: beginFrame no reinicia la arena";
+
+    uint64_t overflows = FrameArena::overflowCount();
+    void* big = FrameArena::allocate(BENCH_ARENA_BYTES, 16);
+    bool overflowed = !arena->owns(big) && FrameArena::overflowCount() == overflows + 1;
+    FrameArena::deallocate(big);
+    if (!overflowed)
+        return "ERROR: el desborde no cae al heap";
+
+    uint64_t heapBefore = bench::allocationCount();
+    size_t usedBefore = arena->used();
+    {
+        ArenaScope scope;
+        FrameVector<uint32_t> list;
+        list.reserve(1000);
+        for (uint32_t i = 0; i < 1000; i++)
+            list.push_back(i);
+        if (!arena->owns(list.data()) || list[999] != 999)
+            return "ERROR: FrameVector no usa la arena";
+    }
+    if (arena->used() != usedBefore)
+        return "ERROR: ArenaScope no devuelve la memoria";
+    if (bench::allocationCount() != heapBefore)
+        return "ERROR: FrameVector asigno en el heap";
+    FrameArena::beginFrame();
+    return nullptr;
+}
+
+static void BM_FrameArena(bench::BenchState& state) {
+    if (const char* error = checkFrameArena()) {
+        state.skip(error);
+        return;
+    }
+    size_t count = (size_t)state.range();
+    for (auto _ : state) {
+        FrameArena::beginFrame();
+        ArenaScope scope;
+        FrameVector<uint32_t> list;
+        list.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            list.push_back((uint32_t)i);
+        bench::doNotOptimize(list.back());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FrameArena)->Range(64, 1 << 16);
+
+// --- LightClusterBuilder::build ---
+// Luces de radio 2..6 repartidas en 100x100 delante de la cámara; el argumento es el
+// número de luces (sin workers, para ver el costo de un solo hilo)
+static void BM_LightClusterBuild(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    std::vector<PointLight> lights(count);
+    uint32_t seed = 1;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return (float)(seed >> 8) / (float)(1u << 24); };
+    for (PointLight& light : lights) {
+        light.position = glm::vec3(random() * 100.0f - 50.0f, random() * 4.0f, -random() * 100.0f);
+        light.radius = 2.0f + random() * 4.0f;
+    }
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 5.0f), glm::vec3(0.0f, 1.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    LightClusterBuilder builder;
+    LightClusterData data;
+    for (auto _ : state) {
+        builder.build(lights.data(), lights.size(), view, projection, 1.0f, 100.0f, nullptr, data);
+        bench::doNotOptimize(data.indices.size());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_LightClusterBuild)->Range(16, 1024);
+
+// --- Grass::scatter ---
+// Hojas de un chunk de 16 m sobre alturas onduladas (lo que hace el render por cada chunk
+// nuevo que entra al alcance del pasto); el argumento es el número de hojas
+static void BM_GrassScatter(bench::BenchState& state) {
+    uint32_t count = (uint32_t)state.range();
+    std::vector<float> heights((size_t)TERRAIN_HEIGHT_SIZE * TERRAIN_HEIGHT_SIZE);
+    for (size_t i = 0; i < heights.size(); i++)
+        heights[i] = std::sin((float)(i % TERRAIN_HEIGHT_SIZE) * 0.3f) + std::cos((float)(i / TERRAIN_HEIGHT_SIZE) * 0.2f);
+    std::vector<GrassBlade> blades(count);
+    for (auto _ : state) {
+        Grass::scatter(heights.data(), glm::vec2(-16.0f, 32.0f), 16.0f, count, blades.data());
+        bench::doNotOptimize(blades[count - 1].position.y);
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_GrassScatter)->Range(1024, 1 << 14);
+
+// --- Registry::each (consulta de dos componentes) ---
+// El argumento es el número de entidades; la mitad tiene también PlayerControl, así la
+// consulta recorre el pool denso de PlayerControl y busca el Transform por entidad
+static void BM_RegistryEach(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    Registry registry;
+    registry.reserve(count);
+    registry.pool<Transform>().reserve(count);
+    registry.pool<PlayerControl>().reserve(count / 2);
+    for (size_t i = 0; i < count; i++) {
+        Entity e = registry.create();
+        registry.add<Transform>(e);
+        if (i % 2 == 0)
+            registry.add<PlayerControl>(e);
+    }
+    for (auto _ : state) {
+        registry.each<PlayerControl, Transform>([](Entity, PlayerControl& control, Transform& transform) {
+            transform.position.x += control.moveSpeed * (1.0f / 60.0f);
+            transform.yaw += control.turnSpeed * (1.0f / 60.0f);
+        });
+        bench::doNotOptimize(registry.get<Transform>(Entity{ 1, 1 }).position.x);
+    }
+    state.setItemsProcessed(state.iterations() * (count / 2));
+}
+BENCHMARK(BM_RegistryEach)->Range(64, 1 << 18);
+
+// --- SceneGraph::update ---
+// Árbol de 4 hijos por nodo; el argumento es el número de nodos. Se mueve sólo la raíz
+// (se recalcula todo) o sólo una hoja (se recalcula un nodo)
+static void buildSceneTree(SceneGraph& graph, size_t count) {
+    graph.reserve(count);
+    graph.addNode(SceneGraph::NO_PARENT);
+    for (size_t i = 1; i < count; i++)
+        graph.addNode((uint32_t)((i - 1) / 4), glm::translate(glm::mat4(1.0f), glm::vec3((float)(i % 4), 1.0f, 0.0f)));
+    graph.update();
+}
+
+static void BM_SceneGraphUpdateRoot(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    SceneGraph graph;
+    buildSceneTree(graph, count);
+    float x = 0.0f;
+    for (auto _ : state) {
+        x += 0.001f;
+        graph.setLocal(0, glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, 0.0f)));
+        bench::doNotOptimize(graph.update());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SceneGraphUpdateRoot)->Range(64, 1 << 16);
+
+static void BM_SceneGraphUpdateLeaf(bench::BenchState& state) {
+    size_t count = (size_t)state.range();
+    SceneGraph graph;
+    buildSceneTree(graph, count);
+    float x = 0.0f;
+    for (auto _ : state) {
+        x += 0.001f;
+        graph.setLocal((uint32_t)(count - 1), glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, 0.0f)));
+        bench::doNotOptimize(graph.update());
+    }
+    state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SceneGraphUpdateLeaf)->Range(64, 1 << 16);
+
+// --- Decodificación de TextureFromFile (stbi_load) ---
+static std::vector<unsigned char> readWholeFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Texturas reales del proyecto, de distintos tamaños y formatos
+static const char* textureAssets[] = {
+    "assets/textures/grass.jpg",
+    "assets/textures/sky.jpg",
+    "assets/goku/Normal.jpg",
+    "assets/goku/Skin Yellow.jpg",
+    "assets/goku/Skin Orange.png",
+    "assets/goku/Skin White.png",
+};
+
+static void BM_TextureDecodeAsset(bench::BenchState& state) {
+    const char* path = textureAssets[state.range()];
+    std::vector<unsigned char> bytes = readWholeFile(path);
+    if (bytes.empty()) {
+        state.skip("(asset no encontrado, ejecutar desde la raiz del proyecto)");
+        return;
+    }
+    uint64_t decodedBytes = 0;
+    for (auto _ : state) {
+        int width, height, nrComponents;
+        unsigned char* data = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &nrComponents, 0);
+        decodedBytes = (uint64_t)width * height * nrComponents;
+        bench::doNotOptimize(data);
+        stbi_image_free(data);
+    }
+    state.setBytesProcessed(state.iterations() * decodedBytes);
+}
+BENCHMARK(BM_TextureDecodeAsset)->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4)->Arg(5);
+
+// Imagen BMP de 24 bits sintética de lado N, para ver cómo escala la decodificación con el tamaño
+static std::vector<unsigned char> makeBmp(int side) {
+    int rowSize = (side * 3 + 3) & ~3;
+    uint32_t pixelBytes = (uint32_t)rowSize * side;
+    uint32_t fileSize = 54 + pixelBytes;
+    std::vector<unsigned char> bmp(fileSize, 0);
+    auto put32 = [&](size_t at, uint32_t v) { std::memcpy(&bmp[at], &v, 4); };
+    auto put16 = [&](size_t at, uint16_t v) { std::memcpy(&bmp[at], &v, 2); };
+    bmp[0] = 'B'; bmp[1] = 'M';
+    put32(2, fileSize);
+    put32(10, 54);
+    put32(14, 40);
+    put32(18, (uint32_t)side);
+    put32(22, (uint32_t)side);
+    put16(26, 1);
+    put16(28, 24);
+    put32(34, pixelBytes);
+    for (int y = 0; y < side; y++)
+        for (int x = 0; x < side * 3; x++)
+            bmp[54 + (size_t)y * rowSize + x] = (unsigned char)((x * 7 + y * 13) & 0xFF);
+    return bmp;
+}
+
+static void BM_TextureDecodeSize(bench::BenchState& state) {
+    int side = (int)state.range();
+    std::vector<unsigned char> bytes = makeBmp(side);
+    for (auto _ : state) {
+        int width, height, nrComponents;
+        unsigned char* data = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &nrComponents, 0);
+        bench::doNotOptimize(data);
+        stbi_image_free(data);
+    }
+    state.setBytesProcessed(state.iterations() * (uint64_t)side * side * 3);
+}
+BENCHMARK(BM_TextureDecodeSize)->Range(128, 4096);
+
+// --- Setters de Shader (necesitan contexto OpenGL) ---
+// model/view/projection ahora van en bloques de uniforms; bones[] (variante SKINNED)
+// sigue siendo un glUniformMatrix4fv normal
+static void BM_ShaderSetMat4(bench::BenchState& state) {
+    if (!gpuShader) { state.skip("(omitido, usar --gpu)"); return; }
+    glm::mat4 m(1.0f);
+    gpuShader->use();
+    for (auto _ : state)
+        gpuShader->setMat4("bones[0]", m);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShaderSetMat4);
+
+// --- RenderGraph::compile ---
+// Cadena de tres texturas iguales: la tercera empieza cuando la primera ya no se usa, así
+// que tienen que compartir la misma textura física (el frame del juego no tiene ese caso).
+// Si no la comparten el caso se marca como error en vez de medir.
+static void BM_RenderGraphCompile(bench::BenchState& state) {
+    if (!gpuStream) { state.skip("(omitido, usar --gpu)"); return; }
+    RenderGraph graph;
+    RenderGraphTextureDesc desc;
+    desc.format = RG_FORMAT_RGBA16F;
+    RenderGraphHandle backbuffer = graph.importTexture("backbuffer", 0);
+    RenderGraphHandle a = RG_INVALID_HANDLE, b = RG_INVALID_HANDLE, c = RG_INVALID_HANDLE;
+    auto nothing = [](const RenderGraphContext&) {};
+    graph.addPass("a", [&](RenderGraph::Builder& pass) { a = pass.create("a", desc); pass.write(a); }, nothing);
+    graph.addPass("b", [&](RenderGraph::Builder& pass) { pass.read(a); b = pass.create("b", desc); pass.write(b); }, nothing);
+    graph.addPass("c", [&](RenderGraph::Builder& pass) { pass.read(b); c = pass.create("c", desc); pass.write(c); }, nothing);
+    graph.addPass("salida", [&](RenderGraph::Builder& pass) { pass.read(c); pass.write(backbuffer); }, nothing);
+    for (auto _ : state)
+        graph.compile(1280, 720);
+    if (graph.texture(a) != graph.texture(c) || graph.texture(a) == graph.texture(b) ||
+        graph.allocatedBytes() * 3 != graph.transientBytes() * 2) {
+        graph.dump();
+        state.skip("ERROR: 'c' no reutiliza la textura de 'a'");
+        return;
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RenderGraphCompile);
+
+// Lo que reemplazó a setMat4("model") + setVec3("lightPos"): escribir ObjectUniforms en el
+// StreamBuffer y enlazarlo. El argumento es cuántos draws hay por frame.
+static void BM_StreamPushObject(bench::BenchState& state) {
+    if (!gpuStream) { state.skip("(omitido, usar --gpu)"); return; }
+    int draws = (int)state.range();
+    ObjectUniforms object;
+    object.model = glm::mat4(1.0f);
+    object.lightPos = glm::vec4(50.0f, 100.0f, 50.0f, 0.0f);
+    for (auto _ : state) {
+        gpuStream->beginFrame();
+        for (int i = 0; i < draws; i++)
+            gpuStream->bindUniform(UBO_OBJECT, gpuStream->pushUniform(object));
+        gpuStream->endFrame();
+    }
+    state.setItemsProcessed(state.iterations() * draws);
+}
+BENCHMARK(BM_StreamPushObject)->Range(8, 1024);
+
+static void BM_ShaderSetInt(bench::BenchState& state) {
+    if (!gpuShader) { state.skip("(omitido, usar --gpu)"); return; }
+    gpuShader->use();
+    for (auto _ : state)
+        gpuShader->setInt("texture_diffuse1", 0);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShaderSetInt);
+
+int main(int argc, char** argv) {
+    bench::Runner runner;
+    bool useGpu = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            runner.filter = argv[++i];
+        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            runner.minSeconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--gpu") == 0)
+            useGpu = true;
+    }
+
+    // Una sub-arena para el hilo del bench (LightClusterBuilder y BM_FrameArena)
+    FrameArena::init(1, BENCH_ARENA_BYTES);
+
+    GLFWwindow* window = nullptr;
+    if (useGpu && glfwInit()) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(64, 64, "bench", NULL, NULL);
+        if (window) {
+            glfwMakeContextCurrent(window);
+            if (gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+                glExt.load();
+                ShaderPermutations permutations("src/basic.vert", "src/basic.frag");
+                gpuShader = new Shader(permutations.get(SHADER_SKINNED));
+                gpuStream = new StreamBuffer();
+                gpuStream->init(1 << 20);
+            }
+        }
+    }
+
+    runner.runAll();
+
+    delete gpuShader;
+    delete gpuStream;
+    if (window) {
+        GpuResources::flush();
+        glfwTerminate();
+    }
+    return 0;
+}
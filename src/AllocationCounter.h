@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// Cuenta las asignaciones de heap hechas con operator new (el reemplazo global vive en
+// AllocationCounter.cpp). Sirve para comprobar que el loop de frames no asigna memoria:
+//
+//   uint64_t before = AllocationCounter::thread();
+//   ...trabajo del frame...
+//   uint64_t allocs = AllocationCounter::thread() - before;
+//
+// Las asignaciones con malloc directo (stb_image, drivers) no se cuentan.
+namespace AllocationCounter {
+    // Todas las asignaciones de todos los hilos desde el inicio
+    uint64_t total();
+    // Asignaciones del hilo que llama
+    uint64_t thread();
+}
+
+// Lleva la cuenta de asignaciones por frame de un hilo después de un calentamiento.
+// En estado estable (cargas hechas, buffers reservados) un frame debería asignar cero.
+class AllocationWatch {
+public:
+    AllocationWatch(const char* name, uint64_t warmupFrames = 120) : name(name), warmup(warmupFrames) {}
+
+    void beginFrame() { before = AllocationCounter::thread(); }
+
+    // Devuelve true la primera vez que un frame estable asigna memoria
+    bool endFrame() {
+        uint64_t allocs = AllocationCounter::thread() - before;
+        if (++frames <= warmup)
+            return false;
+        steadyFrames++;
+        if (allocs == 0)
+            return false;
+        allocations += allocs;
+        return ++framesWithAllocations == 1;
+    }
+
+    void report() const {
+        std::printf("  %s: %llu asignaciones en %llu frames estables (%llu frames con asignaciones)\n", name,
+                    (unsigned long long)allocations, (unsigned long long)steadyFrames,
+                    (unsigned long long)framesWithAllocations);
+    }
+
+    const char* name;
+
+private:
+    uint64_t warmup;
+    uint64_t before = 0;
+    uint64_t frames = 0, steadyFrames = 0;
+    uint64_t allocations = 0, framesWithAllocations = 0;
+};
@@ -0,0 +1,386 @@
+#pragma once
+
+// Clips de animación esquelética comprimidos.
+//
+// Las llaves de Assimp (aiNodeAnim) guardan por cada llave un double de tiempo más vec3,
+// quaternion y vec3 en float, y cada canal con sus propios tiempos. Para guardarlas en
+// memoria de juego se comprimen así:
+//   1. Se re-muestrea cada pista (un nodo/hueso) a frames uniformes (sampleRate).
+//   2. Reducción de llaves: se quitan los frames que la interpolación lineal entre las
+//      llaves vecinas reproduce dentro de la tolerancia (traslación, ángulo y escala).
+//   3. Cuantización: la rotación con "smallest three" (las tres componentes menores en 15
+//      bits, la mayor se reconstruye) y traslación/escala en 16 bits dentro del rango de
+//      la pista.
+//   4. Las llaves de todas las pistas van en un solo arreglo, y cada llave trae juntos su
+//      frame, rotación, traslación y escala (20 bytes): muestrear una pista lee dos llaves
+//      contiguas.
+//
+// El error máximo real (después de cuantizar) se mide contra el re-muestreo original.
+// Sólo CPU.
+
+#include <assimp/anim.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// --- Muestreo de llaves de Assimp (también lo usa tools/vat_bake) ---
+
+template <typename Key>
+inline unsigned int findAssimpKey(const Key* keys, unsigned int count, double ticks) {
+    unsigned int k = 0;
+    while (k + 1 < count && keys[k + 1].mTime <= ticks)
+        k++;
+    return k;
+}
+
+inline glm::vec3 sampleAssimpVector(const aiVectorKey* keys, unsigned int count, double ticks) {
+    unsigned int k = findAssimpKey(keys, count, ticks);
+    const aiVector3D& a = keys[k].mValue;
+    if (k + 1 >= count)
+        return glm::vec3(a.x, a.y, a.z);
+    const aiVector3D& b = keys[k + 1].mValue;
+    double span = keys[k + 1].mTime - keys[k].mTime;
+    float f = span > 0.0 ? (float)((ticks - keys[k].mTime) / span) : 0.0f;
+    f = std::min(std::max(f, 0.0f), 1.0f);
+    return glm::mix(glm::vec3(a.x, a.y, a.z), glm::vec3(b.x, b.y, b.z), f);
+}
+
+inline glm::quat sampleAssimpRotation(const aiQuatKey* keys, unsigned int count, double ticks) {
+    unsigned int k = findAssimpKey(keys, count, ticks);
+    const aiQuaternion& a = keys[k].mValue;
+    if (k + 1 >= count)
+        return glm::quat(a.w, a.x, a.y, a.z);
+    const aiQuaternion& b = keys[k + 1].mValue;
+    double span = keys[k + 1].mTime - keys[k].mTime;
+    float f = span > 0.0 ? (float)((ticks - keys[k].mTime) / span) : 0.0f;
+    f = std::min(std::max(f, 0.0f), 1.0f);
+    return glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), f);
+}
+
+// --- Clip sin comprimir (frames uniformes) ---
+
+struct AnimationPose {
+    glm::vec3 translation = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+
+    glm::mat4 matrix() const {
+        glm::mat4 m = glm::mat4_cast(rotation);
+        m[0] *= scale.x;
+        m[1] *= scale.y;
+        m[2] *= scale.z;
+        m[3] = glm::vec4(translation, 1.0f);
+        return m;
+    }
+};
+
+struct RawAnimationTrack {
+    std::string node;
+    std::vector<AnimationPose> frames;
+};
+
+struct RawAnimationClip {
+    std::string name;
+    float sampleRate = 30.0f;
+    uint32_t frameCount = 0;     // Todas las pistas tienen los mismos frames
+    size_t sourceBytes = 0;      // Lo que ocupaban las llaves de Assimp
+    std::vector<RawAnimationTrack> tracks;
+
+    float duration() const { return frameCount > 1 ? (frameCount - 1) / sampleRate : 0.0f; }
+
+    static RawAnimationClip fromAssimp(const aiAnimation* animation, float sampleRate = 30.0f) {
+        RawAnimationClip clip;
+        clip.name = animation->mName.C_Str();
+        clip.sampleRate = sampleRate;
+        double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+        // Los frames se guardan en 16 bits (más de 30 minutos a 30 fps)
+        clip.frameCount = (uint32_t)std::min<long>(std::lround(animation->mDuration / ticksPerSecond * sampleRate) + 1, 65535);
+        clip.tracks.resize(animation->mNumChannels);
+        for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+            const aiNodeAnim* channel = animation->mChannels[c];
+            clip.sourceBytes += channel->mNumPositionKeys * sizeof(aiVectorKey) + channel->mNumRotationKeys * sizeof(aiQuatKey)
+                              + channel->mNumScalingKeys * sizeof(aiVectorKey);
+            RawAnimationTrack& track = clip.tracks[c];
+            track.node = channel->mNodeName.C_Str();
+            track.frames.resize(clip.frameCount);
+            for (uint32_t f = 0; f < clip.frameCount; f++) {
+                double ticks = f / (double)sampleRate * ticksPerSecond;
+                AnimationPose& pose = track.frames[f];
+                if (channel->mNumPositionKeys > 0)
+                    pose.translation = sampleAssimpVector(channel->mPositionKeys, channel->mNumPositionKeys, ticks);
+                if (channel->mNumRotationKeys > 0)
+                    pose.rotation = sampleAssimpRotation(channel->mRotationKeys, channel->mNumRotationKeys, ticks);
+                if (channel->mNumScalingKeys > 0)
+                    pose.scale = sampleAssimpVector(channel->mScalingKeys, channel->mNumScalingKeys, ticks);
+            }
+        }
+        return clip;
+    }
+};
+
+// --- Clip comprimido ---
+
+struct AnimationCompressionSettings {
+    float translationTolerance = 0.001f; // Unidades del archivo
+    float rotationTolerance = 0.1f;      // Grados
+    float scaleTolerance = 0.001f;
+};
+
+// Una llave: frame + rotación smallest-three + traslación y escala cuantizadas (20 bytes)
+struct PackedAnimationKey {
+    uint16_t frame;
+    uint16_t rotation[3];    // Bit 15 de [0] y [1]: índice de la componente omitida
+    uint16_t translation[3];
+    uint16_t scale[3];
+};
+static_assert(sizeof(PackedAnimationKey) == 20, "PackedAnimationKey debe ocupar 20 bytes");
+
+struct CompressedAnimationTrack {
+    uint32_t firstKey = 0;
+    uint32_t keyCount = 0;
+    glm::vec3 translationMin = glm::vec3(0.0f), translationExtent = glm::vec3(0.0f);
+    glm::vec3 scaleMin = glm::vec3(1.0f), scaleExtent = glm::vec3(0.0f);
+};
+
+class CompressedAnimationClip {
+public:
+    std::string name;
+    float sampleRate = 30.0f;
+    uint32_t frameCount = 0;
+    std::vector<std::string> nodes;             // Paralelo a tracks
+    std::vector<CompressedAnimationTrack> tracks;
+    std::vector<PackedAnimationKey> keys;
+
+    // Estadísticas de la compresión
+    size_t sourceBytes = 0;
+    size_t sampledKeys = 0;
+    float maxTranslationError = 0.0f, maxRotationError = 0.0f, maxScaleError = 0.0f;
+
+    float duration() const { return frameCount > 1 ? (frameCount - 1) / sampleRate : 0.0f; }
+
+    size_t bytes() const {
+        return keys.size() * sizeof(PackedAnimationKey) + tracks.size() * sizeof(CompressedAnimationTrack);
+    }
+
+    static CompressedAnimationClip compress(const RawAnimationClip& raw, const AnimationCompressionSettings& settings = AnimationCompressionSettings()) {
+        CompressedAnimationClip clip;
+        clip.name = raw.name;
+        clip.sampleRate = raw.sampleRate;
+        clip.frameCount = raw.frameCount;
+        clip.sourceBytes = raw.sourceBytes;
+        clip.tracks.reserve(raw.tracks.size());
+        clip.nodes.reserve(raw.tracks.size());
+        float cosTolerance = std::cos(glm::radians(settings.rotationTolerance) * 0.5f);
+
+        std::vector<uint32_t> kept;
+        for (const RawAnimationTrack& rawTrack : raw.tracks) {
+            const std::vector<AnimationPose>& frames = rawTrack.frames;
+            CompressedAnimationTrack track;
+            track.firstKey = (uint32_t)clip.keys.size();
+            clip.nodes.push_back(rawTrack.node);
+            clip.sampledKeys += frames.size();
+            if (frames.empty()) {
+                clip.tracks.push_back(track);
+                continue;
+            }
+
+            // Rangos de la pista para cuantizar
+            glm::vec3 tMin(frames[0].translation), tMax(tMin), sMin(frames[0].scale), sMax(sMin);
+            for (const AnimationPose& pose : frames) {
+                tMin = glm::min(tMin, pose.translation);
+                tMax = glm::max(tMax, pose.translation);
+                sMin = glm::min(sMin, pose.scale);
+                sMax = glm::max(sMax, pose.scale);
+            }
+            track.translationMin = tMin;
+            track.translationExtent = tMax - tMin;
+            track.scaleMin = sMin;
+            track.scaleExtent = sMax - sMin;
+
+            // Reducción: desde la última llave guardada se alarga el tramo mientras todos los
+            // frames intermedios queden dentro de la tolerancia
+            kept.clear();
+            kept.push_back(0);
+            uint32_t start = 0;
+            uint32_t last = (uint32_t)frames.size() - 1;
+            while (start < last) {
+                uint32_t end = start + 1;
+                while (end < last && spanFits(frames, start, end + 1, settings, cosTolerance))
+                    end++;
+                kept.push_back(end);
+                start = end;
+            }
+            // Pista constante: con una sola llave basta
+            if (kept.size() == 2 && spanFits(frames, 0, last, settings, cosTolerance) && posesClose(frames[0], frames[last], settings, cosTolerance))
+                kept.pop_back();
+
+            for (uint32_t frame : kept)
+                clip.keys.push_back(packKey(frame, frames[frame], track));
+            track.keyCount = (uint32_t)kept.size();
+            clip.tracks.push_back(track);
+        }
+
+        clip.measureError(raw);
+        return clip;
+    }
+
+    // Pose de una pista en un frame (fraccionario, sin repetir: se limita al rango)
+    AnimationPose sampleTrack(size_t trackIndex, float frame) const {
+        const CompressedAnimationTrack& track = tracks[trackIndex];
+        if (track.keyCount == 0)
+            return AnimationPose();
+        const PackedAnimationKey* first = keys.data() + track.firstKey;
+        if (track.keyCount == 1 || frame <= first[0].frame)
+            return unpackKey(first[0], track);
+        const PackedAnimationKey* lastKey = first + track.keyCount - 1;
+        if (frame >= lastKey->frame)
+            return unpackKey(*lastKey, track);
+
+        // Búsqueda binaria de la llave con frame <= 'frame'
+        uint32_t low = 0, high = track.keyCount - 1;
+        while (high - low > 1) {
+            uint32_t middle = (low + high) / 2;
+            if (first[middle].frame <= frame)
+                low = middle;
+            else
+                high = middle;
+        }
+        const PackedAnimationKey& a = first[low];
+        const PackedAnimationKey& b = first[high];
+        float f = (frame - a.frame) / (float)(b.frame - a.frame);
+        return interpolate(unpackKey(a, track), unpackKey(b, track), f);
+    }
+
+    // Todas las pistas en 'seconds' (el clip se repite). out debe tener tracks.size() poses.
+    void sample(float seconds, AnimationPose* out) const {
+        float frame = 0.0f;
+        if (frameCount > 1) {
+            float length = (float)(frameCount - 1);
+            frame = std::fmod(seconds * sampleRate, length);
+            if (frame < 0.0f)
+                frame += length;
+        }
+        for (size_t t = 0; t < tracks.size(); t++)
+            out[t] = sampleTrack(t, frame);
+    }
+
+    void report() const {
+        std::printf("[Animacion] %s: %zu pistas, %.2f s | llaves %zu -> %zu | %zu KB -> %.1f KB (%.1fx) | error max %.4f u, %.3f grados, escala %.4f\n",
+                    name.c_str(), tracks.size(), duration(), sampledKeys, keys.size(), sourceBytes / 1024,
+                    bytes() / 1024.0, bytes() > 0 ? (double)sourceBytes / bytes() : 0.0,
+                    maxTranslationError, maxRotationError, maxScaleError);
+    }
+
+    static AnimationPose interpolate(const AnimationPose& a, const AnimationPose& b, float f) {
+        AnimationPose pose;
+        pose.translation = glm::mix(a.translation, b.translation, f);
+        pose.scale = glm::mix(a.scale, b.scale, f);
+        // nlerp por el camino corto: más barato que slerp y suficiente entre llaves cercanas
+        glm::quat to = glm::dot(a.rotation, b.rotation) < 0.0f ? -b.rotation : b.rotation;
+        pose.rotation = glm::normalize(glm::quat(glm::mix(a.rotation.w, to.w, f), glm::mix(a.rotation.x, to.x, f),
+                                                 glm::mix(a.rotation.y, to.y, f), glm::mix(a.rotation.z, to.z, f)));
+        return pose;
+    }
+
+private:
+    static bool posesClose(const AnimationPose& a, const AnimationPose& b, const AnimationCompressionSettings& settings, float cosTolerance) {
+        return glm::length(a.translation - b.translation) <= settings.translationTolerance
+            && std::fabs(glm::dot(a.rotation, b.rotation)) >= cosTolerance
+            && glm::length(a.scale - b.scale) <= settings.scaleTolerance;
+    }
+
+    static bool spanFits(const std::vector<AnimationPose>& frames, uint32_t start, uint32_t end,
+                         const AnimationCompressionSettings& settings, float cosTolerance) {
+        for (uint32_t k = start + 1; k < end; k++) {
+            float f = (float)(k - start) / (float)(end - start);
+            if (!posesClose(interpolate(frames[start], frames[end], f), frames[k], settings, cosTolerance))
+                return false;
+        }
+        return true;
+    }
+
+    static uint16_t quantize(float value, float minimum, float extent) {
+        if (extent <= 0.0f)
+            return 0;
+        float unit = std::min(std::max((value - minimum) / extent, 0.0f), 1.0f);
+        return (uint16_t)std::lround(unit * 65535.0f);
+    }
+
+    static float dequantize(uint16_t value, float minimum, float extent) {
+        return minimum + value * (1.0f / 65535.0f) * extent;
+    }
+
+    static PackedAnimationKey packKey(uint32_t frame, const AnimationPose& pose, const CompressedAnimationTrack& track) {
+        PackedAnimationKey key;
+        key.frame = (uint16_t)frame;
+        for (int c = 0; c < 3; c++) {
+            key.translation[c] = quantize(pose.translation[c], track.translationMin[c], track.translationExtent[c]);
+            key.scale[c] = quantize(pose.scale[c], track.scaleMin[c], track.scaleExtent[c]);
+        }
+
+        // Smallest three: se omite la componente mayor (se fuerza positiva, q y -q son la
+        // misma rotación) y las otras tres caben en [-1/sqrt(2), 1/sqrt(2)]
+        glm::quat q = glm::normalize(pose.rotation);
+        float components[4] = { q.x, q.y, q.z, q.w };
+        int largest = 0;
+        for (int c = 1; c < 4; c++)
+            if (std::fabs(components[c]) > std::fabs(components[largest]))
+                largest = c;
+        float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+        int out = 0;
+        for (int c = 0; c < 4; c++) {
+            if (c == largest)
+                continue;
+            float unit = (components[c] * sign * SQRT2 + 1.0f) * 0.5f;
+            key.rotation[out++] = (uint16_t)std::lround(std::min(std::max(unit, 0.0f), 1.0f) * 32767.0f);
+        }
+        key.rotation[0] |= (uint16_t)((largest >> 1) << 15);
+        key.rotation[1] |= (uint16_t)((largest & 1) << 15);
+        return key;
+    }
+
+    static AnimationPose unpackKey(const PackedAnimationKey& key, const CompressedAnimationTrack& track) {
+        AnimationPose pose;
+        for (int c = 0; c < 3; c++) {
+            pose.translation[c] = dequantize(key.translation[c], track.translationMin[c], track.translationExtent[c]);
+            pose.scale[c] = dequantize(key.scale[c], track.scaleMin[c], track.scaleExtent[c]);
+        }
+        int largest = ((key.rotation[0] >> 15) << 1) | (key.rotation[1] >> 15);
+        float components[4];
+        float sum = 0.0f;
+        int in = 0;
+        for (int c = 0; c < 4; c++) {
+            if (c == largest)
+                continue;
+            float unit = (key.rotation[in++] & 0x7FFF) * (1.0f / 32767.0f);
+            components[c] = (unit * 2.0f - 1.0f) * (1.0f / SQRT2);
+            sum += components[c] * components[c];
+        }
+        components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+        pose.rotation = glm::quat(components[3], components[0], components[1], components[2]);
+        return pose;
+    }
+
+    void measureError(const RawAnimationClip& raw) {
+        maxTranslationError = maxRotationError = maxScaleError = 0.0f;
+        for (size_t t = 0; t < raw.tracks.size(); t++) {
+            const std::vector<AnimationPose>& frames = raw.tracks[t].frames;
+            for (size_t f = 0; f < frames.size(); f++) {
+                AnimationPose pose = sampleTrack(t, (float)f);
+                maxTranslationError = std::max(maxTranslationError, glm::length(pose.translation - frames[f].translation));
+                maxScaleError = std::max(maxScaleError, glm::length(pose.scale - frames[f].scale));
+                float cosHalf = std::min(1.0f, std::fabs(glm::dot(pose.rotation, glm::normalize(frames[f].rotation))));
+                maxRotationError = std::max(maxRotationError, glm::degrees(2.0f * std::acos(cosHalf)));
+            }
+        }
+    }
+
+    static constexpr float SQRT2 = 1.41421356f;
+};
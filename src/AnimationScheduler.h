@@ -0,0 +1,172 @@
+#pragma once
+
+// Actualización de animaciones por nivel de detalle.
+//
+// Cada tick el tiempo de todos los Animator avanza (así nadie se desfasa), pero la pose
+// sólo se evalúa para algunos:
+//   - Fuera de la cámara (frustum): nunca, hasta que vuelvan a verse.
+//   - Visibles: cada 1, 2 o 4 ticks según el tamaño que ocupan en pantalla (radio entre
+//     distancia, en proporción a la altura de la pantalla).
+// Los que tocan cada N ticks se reparten por fase (índice de la entidad), así no se juntan
+// todos en el mismo tick. Además hay un tope de poses por tick: si hay más candidatos se
+// evalúan primero los de mayor prioridad (tamaño en pantalla x ticks sin actualizar) y el
+// resto espera al siguiente tick.
+//
+// La evaluación de las poses se reparte entre los workers.
+
+#include <glm/glm.hpp>
+
+#include "AnimationClip.h"
+#include "Components.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "Registry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+enum AnimationLod : uint8_t {
+    ANIMATION_LOD_FULL,    // Cada tick
+    ANIMATION_LOD_HALF,    // Cada 2 ticks
+    ANIMATION_LOD_QUARTER, // Cada 4 ticks
+    ANIMATION_LOD_CULLED,  // Fuera de la cámara: sólo avanza el tiempo
+    ANIMATION_LOD_COUNT
+};
+
+// Personaje con animación esquelética. 'pose' tiene una entrada por pista del clip.
+struct Animator {
+    const CompressedAnimationClip* clip = nullptr;
+    float time = 0.0f;
+    float speed = 1.0f;
+    float radius = 1.0f;        // Esfera que lo contiene, centrada un poco arriba de Transform
+    float centerHeight = 1.0f;
+    AnimationLod lod = ANIMATION_LOD_FULL;
+    uint64_t lastUpdateTick = 0;
+    bool poseValid = false;
+    std::vector<AnimationPose> pose;
+
+    void setClip(const CompressedAnimationClip* newClip) {
+        clip = newClip;
+        pose.assign(clip ? clip->tracks.size() : 0, AnimationPose());
+        poseValid = false;
+    }
+};
+
+class AnimationScheduler {
+public:
+    // Tamaño en pantalla (fracción de la altura) para cada nivel
+    float fullRateScreenSize = 0.25f;
+    float halfRateScreenSize = 0.08f;
+    size_t maxUpdatesPerTick = 256;
+
+    void reserve(size_t characters) {
+        candidates.reserve(characters);
+        selected.reserve(characters);
+    }
+
+    // cameraPos y projection para medir el tamaño en pantalla; viewProjection para el frustum
+    void update(Registry& registry, float dt, const glm::vec3& cameraPos, const glm::mat4& projection,
+                const glm::mat4& viewProjection, JobSystem* jobs) {
+        tick++;
+        candidates.clear();
+        selected.clear();
+        for (uint32_t l = 0; l < ANIMATION_LOD_COUNT; l++)
+            lodCounts[l] = 0;
+
+        Frustum frustum = Frustum::fromMatrix(viewProjection);
+        // projection[1][1] = 1 / tan(fov/2): radio / distancia * eso = fracción de media pantalla
+        float screenScale = projection[1][1] * 0.5f;
+
+        registry.each<Animator, Transform>([&](Entity e, Animator& animator, Transform& transform) {
+            if (!animator.clip)
+                return;
+            animator.time += dt * animator.speed;
+
+            glm::vec3 center = transform.position + glm::vec3(0.0f, animator.centerHeight, 0.0f);
+            uint32_t rate = 0;
+            float screenSize = 0.0f;
+            if (!frustum.intersectsSphere(center, animator.radius)) {
+                animator.lod = ANIMATION_LOD_CULLED;
+            } else {
+                float distance = std::max(glm::length(center - cameraPos), animator.radius);
+                screenSize = animator.radius / distance * screenScale * 2.0f;
+                animator.lod = screenSize >= fullRateScreenSize ? ANIMATION_LOD_FULL
+                             : screenSize >= halfRateScreenSize ? ANIMATION_LOD_HALF
+                             : ANIMATION_LOD_QUARTER;
+                rate = 1u << animator.lod;
+            }
+            lodCounts[animator.lod]++;
+            if (rate == 0)
+                return;
+
+            // Le toca por su fase, nunca se evaluó (recién visible) o el tope lo dejó fuera y
+            // ya pasó su periodo: sigue siendo candidato en cada tick hasta que lo evalúen
+            bool due = (tick + e.index) % rate == 0 || !animator.poseValid || tick - animator.lastUpdateTick >= rate;
+            if (!due)
+                return;
+            float staleness = (float)(tick - animator.lastUpdateTick);
+            candidates.push_back({ &animator, screenSize * staleness });
+        });
+
+        // Tope por tick: los de mayor prioridad primero
+        if (candidates.size() > maxUpdatesPerTick) {
+            std::nth_element(candidates.begin(), candidates.begin() + maxUpdatesPerTick, candidates.end(),
+                             [](const Candidate& a, const Candidate& b) { return a.priority > b.priority; });
+            deferred = candidates.size() - maxUpdatesPerTick;
+            candidates.resize(maxUpdatesPerTick);
+        } else {
+            deferred = 0;
+        }
+        for (const Candidate& c : candidates)
+            selected.push_back(c.animator);
+
+        auto evaluate = [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Animator& animator = *selected[i];
+                animator.clip->sample(animator.time, animator.pose.data());
+                animator.poseValid = true;
+                animator.lastUpdateTick = tick;
+            }
+        };
+        if (jobs)
+            jobs->parallel_for(selected.size(), 16, evaluate);
+        else
+            evaluate(0, selected.size());
+
+        updated = selected.size();
+        totalUpdated += updated;
+        totalDeferred += deferred;
+        totalCharacterTicks += lodCounts[ANIMATION_LOD_FULL] + lodCounts[ANIMATION_LOD_HALF]
+                             + lodCounts[ANIMATION_LOD_QUARTER] + lodCounts[ANIMATION_LOD_CULLED];
+    }
+
+    size_t updatedLastTick() const { return updated; }
+    size_t deferredLastTick() const { return deferred; }
+    uint32_t lodCount(AnimationLod lod) const { return lodCounts[lod]; }
+
+    void report() const {
+        std::printf("Animacion: %llu ticks, %.1f%% de las poses evaluadas (%llu de %llu), %llu pospuestas por el tope | "
+                    "ultimo tick: %u completos, %u a 1/2, %u a 1/4, %u fuera de camara\n",
+                    (unsigned long long)tick,
+                    totalCharacterTicks > 0 ? 100.0 * totalUpdated / totalCharacterTicks : 0.0,
+                    (unsigned long long)totalUpdated, (unsigned long long)totalCharacterTicks,
+                    (unsigned long long)totalDeferred, lodCounts[ANIMATION_LOD_FULL], lodCounts[ANIMATION_LOD_HALF],
+                    lodCounts[ANIMATION_LOD_QUARTER], lodCounts[ANIMATION_LOD_CULLED]);
+    }
+
+private:
+    struct Candidate {
+        Animator* animator;
+        float priority;
+    };
+
+    uint64_t tick = 0;
+    std::vector<Candidate> candidates;
+    std::vector<Animator*> selected;
+    uint32_t lodCounts[ANIMATION_LOD_COUNT] = {};
+    size_t updated = 0, deferred = 0;
+    uint64_t totalUpdated = 0, totalDeferred = 0, totalCharacterTicks = 0;
+};
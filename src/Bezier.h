@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <xmmintrin.h>
+
+// Curva de Bézier cúbica: p0 y p3 son los extremos, p1 y p2 los puntos de control
+inline glm::vec3 calculateBezier(float t, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
+    float u = 1.0f - t;
+    float tt = t * t;
+    float uu = u * u;
+    float uuu = uu * u;
+    float ttt = tt * t;
+    glm::vec3 p = uuu * p0; 
+    p += 3 * uu * t * p1;   
+    p += 3 * u * tt * p2;   
+    p += ttt * p3;          
+    return p;
+}
+
+// Puntos de control de muchas curvas en estructura de arreglos: p0x[i], p0y[i]... son los de
+// la curva i. Todos los arreglos deben estar alineados a 16 bytes.
+struct BezierCurvesSoA {
+    const float *p0x, *p0y, *p0z;
+    const float *p1x, *p1y, *p1z;
+    const float *p2x, *p2y, *p2z;
+    const float *p3x, *p3y, *p3z;
+};
+
+// Evalúa la curva i en t[i] para i en [0, count), 4 curvas por instrucción con SSE.
+// outX/outY/outZ también deben estar alineados a 16 bytes.
+inline void calculateBezierBatch(const BezierCurvesSoA& c, const float* t,
+                                 float* outX, float* outY, float* outZ, size_t count) {
+    size_t i = 0;
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 tv = _mm_load_ps(t + i);
+        __m128 u = _mm_sub_ps(one, tv);
+        __m128 tt = _mm_mul_ps(tv, tv);
+        __m128 uu = _mm_mul_ps(u, u);
+        // Pesos de Bernstein: u^3, 3u^2t, 3ut^2, t^3
+        __m128 b0 = _mm_mul_ps(uu, u);
+        __m128 b1 = _mm_mul_ps(three, _mm_mul_ps(uu, tv));
+        __m128 b2 = _mm_mul_ps(three, _mm_mul_ps(u, tt));
+        __m128 b3 = _mm_mul_ps(tt, tv);
+
+        __m128 x = _mm_mul_ps(b0, _mm_load_ps(c.p0x + i));
+        x = _mm_add_ps(x, _mm_mul_ps(b1, _mm_load_ps(c.p1x + i)));
+        x = _mm_add_ps(x, _mm_mul_ps(b2, _mm_load_ps(c.p2x + i)));
+        x = _mm_add_ps(x, _mm_mul_ps(b3, _mm_load_ps(c.p3x + i)));
+        _mm_store_ps(outX + i, x);
+
+        __m128 y = _mm_mul_ps(b0, _mm_load_ps(c.p0y + i));
+        y = _mm_add_ps(y, _mm_mul_ps(b1, _mm_load_ps(c.p1y + i)));
+        y = _mm_add_ps(y, _mm_mul_ps(b2, _mm_load_ps(c.p2y + i)));
+        y = _mm_add_ps(y, _mm_mul_ps(b3, _mm_load_ps(c.p3y + i)));
+        _mm_store_ps(outY + i, y);
+
+        __m128 z = _mm_mul_ps(b0, _mm_load_ps(c.p0z + i));
+        z = _mm_add_ps(z, _mm_mul_ps(b1, _mm_load_ps(c.p1z + i)));
+        z = _mm_add_ps(z, _mm_mul_ps(b2, _mm_load_ps(c.p2z + i)));
+        z = _mm_add_ps(z, _mm_mul_ps(b3, _mm_load_ps(c.p3z + i)));
+        _mm_store_ps(outZ + i, z);
+    }
+    for (; i < count; i++) {
+        glm::vec3 p = calculateBezier(t[i],
+                                      glm::vec3(c.p0x[i], c.p0y[i], c.p0z[i]), glm::vec3(c.p1x[i], c.p1y[i], c.p1z[i]),
+                                      glm::vec3(c.p2x[i], c.p2y[i], c.p2z[i]), glm::vec3(c.p3x[i], c.p3y[i], c.p3z[i]));
+        outX[i] = p.x;
+        outY[i] = p.y;
+        outZ[i] = p.z;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+// Bloom sobre una cadena de niveles reducidos (pases del grafo de render).
+//
+// La escena HDR se reduce a un cuarto de resolución con umbral (sólo pasa lo que brilla
+// más que 'threshold', como las bolas de energía) y de ahí a la mitad por nivel hasta
+// BLOOM_LEVELS. Después se sube nivel por nivel con un filtro tienda, sumando cada nivel
+// al siguiente más grande. El resultado queda en el nivel 0 y se suma a la escena en el
+// escalado final (DynamicResolution::upscale).
+//
+// El costo son 2 * BLOOM_LEVELS - 1 pases a pantalla completa de texturas chicas, sin
+// importar el radio del brillo: los niveles chicos dan el halo ancho y los grandes el
+// núcleo. Como la escena, cada nivel usa sólo la parte que corresponde a la escala actual.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "DynamicResolution.h"
+#include "GpuResources.h"
+#include "RenderGraph.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const int BLOOM_LEVELS = 5; // 1/4 a 1/64 de la ventana
+
+struct BloomSettings {
+    float threshold = 1.5f;  // Brillo desde el que una superficie empieza a brillar
+    float knee = 0.5f;       // Transición suave alrededor del umbral
+    float intensity = 0.6f;  // Cuánto del resultado se suma a la escena
+    float radius = 1.0f;     // Separación del filtro al subir (en texels)
+};
+
+class Bloom {
+public:
+    BloomSettings settings;
+
+    // Hilo con el contexto
+    void init(const BloomSettings& newSettings) {
+        settings = newSettings;
+        downShader = Shader("src/upscale.vert", "src/bloom_down.frag");
+        downShader.use();
+        downShader.setInt("source", 0);
+        upShader = Shader("src/upscale.vert", "src/bloom_up.frag");
+        upShader.use();
+        upShader.setInt("source", 0);
+        emptyVAO = GpuVertexArray::generate();
+    }
+
+    // Agrega los pases que leen 'sceneColor'; devuelve el nivel 0 con el bloom completo
+    RenderGraphHandle addPasses(RenderGraph& graph, RenderGraphHandle sceneColor, const DynamicResolution& resolution) {
+        static const char* const names[BLOOM_LEVELS] = { "bloom0", "bloom1", "bloom2", "bloom3", "bloom4" };
+        static const char* const downNames[BLOOM_LEVELS] = { "bloom_reducir0", "bloom_reducir1", "bloom_reducir2", "bloom_reducir3", "bloom_reducir4" };
+        static const char* const upNames[BLOOM_LEVELS] = { "bloom_ampliar0", "bloom_ampliar1", "bloom_ampliar2", "bloom_ampliar3", "bloom_ampliar4" };
+        const DynamicResolution* scale = &resolution;
+
+        for (int i = 0; i < BLOOM_LEVELS; i++) {
+            RenderGraphHandle source = i == 0 ? sceneColor : levels[i - 1];
+            graph.addPass(downNames[i],
+                [&](RenderGraph::Builder& pass) {
+                    RenderGraphTextureDesc desc;
+                    desc.format = RG_FORMAT_R11G11B10F;
+                    desc.scale = 0.25f / (float)(1 << i);
+                    levels[i] = pass.create(names[i], desc);
+                    pass.read(source);
+                    pass.write(levels[i]);
+                },
+                [this, i, source, scale](const RenderGraphContext& context) {
+                    downShader.use();
+                    glDisable(GL_BLEND);
+                    downShader.setBool("prefilter", i == 0);
+                    float knee = std::max(settings.knee, 1e-4f);
+                    downShader.setVec4("threshold", glm::vec4(settings.threshold, settings.threshold - knee, 2.0f * knee, 0.25f / knee));
+                    draw(downShader, context, source, levels[i], *scale);
+                    glEnable(GL_BLEND);
+                });
+        }
+        for (int i = BLOOM_LEVELS - 2; i >= 0; i--) {
+            RenderGraphHandle source = levels[i + 1];
+            graph.addPass(upNames[i],
+                [&](RenderGraph::Builder& pass) {
+                    pass.read(source);
+                    pass.write(levels[i]);
+                },
+                [this, i, source, scale](const RenderGraphContext& context) {
+                    upShader.use();
+                    upShader.setFloat("radius", settings.radius);
+                    glBlendFunc(GL_ONE, GL_ONE);
+                    draw(upShader, context, source, levels[i], *scale);
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                });
+        }
+        return levels[0];
+    }
+
+private:
+    Shader downShader, upShader;
+    GpuVertexArray emptyVAO;
+    RenderGraphHandle levels[BLOOM_LEVELS] = {};
+
+    // Un pase a pantalla completa sobre la parte usada de 'target', leyendo la parte usada de 'source'
+    void draw(Shader& shader, const RenderGraphContext& context, RenderGraphHandle source, RenderGraphHandle target,
+              const DynamicResolution& resolution) {
+        int sourceWidth = context.textureWidth(source), sourceHeight = context.textureHeight(source);
+        shader.setVec2("sourceRegion", glm::vec2((float)resolution.scaled(sourceWidth) / sourceWidth,
+                                                 (float)resolution.scaled(sourceHeight) / sourceHeight));
+        shader.setVec2("sourceTexel", glm::vec2(1.0f / sourceWidth, 1.0f / sourceHeight));
+        glViewport(0, 0, resolution.scaled(context.textureWidth(target)), resolution.scaled(context.textureHeight(target)));
+        glDisable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, context.texture(source));
+        glBindVertexArray(emptyVAO.id());
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glEnable(GL_DEPTH_TEST);
+    }
+};
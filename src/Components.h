@@ -0,0 +1,67 @@
+#pragma once
+
+// Componentes del juego (datos planos; la lógica está en los sistemas de main.cpp).
+
+#include <glm/glm.hpp>
+
+#include "Registry.h"
+
+#include <cstdint>
+
+// Posición en el mundo y hacia dónde mira (grados alrededor de Y)
+struct Transform {
+    glm::vec3 position = glm::vec3(0.0f);
+    float yaw = 0.0f;
+};
+
+// Personaje que se mueve con el teclado (estilo tanque: W/S avanzan, A/D giran)
+struct PlayerControl {
+    float moveSpeed = 4.0f;   // Unidades por segundo
+    float turnSpeed = 90.0f;  // Grados por segundo
+    bool moving = false;
+};
+
+// Dispara bolas de energía mientras se mantiene ESPACIO. Los proyectiles en vuelo no son
+// entidades: viven en el ProjectilePool, que ya los guarda como arreglos contiguos.
+struct Weapon {
+    float interval = 0.2f;    // Segundos entre disparos
+    float cooldown = 0.0f;
+    uint32_t shotsFired = 0;
+    float range = 10.0f;
+    float flightTime = 1.0f / 1.5f;
+};
+
+// Cámara que orbita alrededor de una entidad, controlada por el mouse
+struct OrbitCamera {
+    Entity target;
+    float angleAround = 0.0f; // Grados alrededor de Y
+    float distance = 7.0f;
+    float height = 3.0f;
+    float smoothing = 10.0f;
+    glm::vec3 position = glm::vec3(0.0f, 2.0f, 6.0f);
+};
+
+// Copia la posición de otra entidad cada tick (ej. el cielo sigue al jugador)
+struct FollowTarget {
+    Entity target;
+};
+
+// Personaje de la multitud: reproduce un clip horneado (VatCrowd) desde la GPU. No se mueve,
+// así que su matriz y sus parámetros de animación se calculan una vez al crearlo.
+struct CrowdMember {
+    uint32_t clip = 0;
+    float timeOffset = 0.0f;  // Segundos, para que no se muevan todos al mismo tiempo
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec4 anim = glm::vec4(0.0f);  // Ver VatInstance
+};
+
+// Tapa lo que está detrás: su malla simplificada se rasteriza en el OcclusionBuffer
+struct OccluderMesh;
+struct Occluder {
+    const OccluderMesh* mesh = nullptr;
+};
+
+// Nodo del SceneGraph que recibe el Transform de la entidad
+struct SceneNode {
+    uint32_t node = 0;
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+// Resolución dinámica según el tiempo de GPU.
+//
+// La escena se dibuja a (ventana x escala) en una textura del grafo de render y después un
+// pase de escalado con nitidez la lleva al backbuffer. La escala se ajusta cada frame con el tiempo de GPU
+// medido (GL_TIME_ELAPSED alrededor de la escena) para acercarse al objetivo:
+//   - Los píxeles crecen con escala², así que para pasar de 'ms' a 'objetivo' la escala se
+//     multiplica por sqrt(objetivo / ms), con pasos limitados para que no oscile.
+//   - Las consultas se leen varios frames después (anillo de QUERY_COUNT) sin esperar a la
+//     GPU; si todavía no hay resultado, la escala se queda igual.
+//
+// Las texturas de la escena tienen el tamaño completo de la ventana y la escena usa sólo la
+// esquina que le toca: cambiar de escala no reasigna nada, sólo cambia el viewport.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GpuResources.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+struct DynamicResolutionSettings {
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float targetMs = 1000.0f / 60.0f;  // Tiempo de GPU objetivo por frame
+    float sharpness = 0.6f;            // Nitidez con la escala mínima (0 = sólo bilineal)
+};
+
+class DynamicResolution {
+public:
+    DynamicResolutionSettings settings;
+
+    // Hilo con el contexto
+    void init(const DynamicResolutionSettings& newSettings) {
+        settings = newSettings;
+        settings.minScale = std::min(std::max(settings.minScale, 0.1f), 1.0f);
+        settings.maxScale = std::min(std::max(settings.maxScale, settings.minScale), 1.0f);
+        scale = settings.maxScale;
+
+        shader = Shader("src/upscale.vert", "src/upscale.frag");
+        shader.use();
+        shader.setInt("sceneColor", 0);
+        shader.setInt("bloom", 1);
+        emptyVAO = GpuVertexArray::generate();
+        for (GpuQuery& query : queries)
+            query = GpuQuery::generate();
+    }
+
+    // Antes de dibujar la escena (con su framebuffer ya enlazado): viewport escalado.
+    // Minimizada (0x0) no hay escena: ni consulta de tiempo ni escalado en este frame.
+    void beginScene(int windowWidth, int windowHeight) {
+        sceneReady = windowWidth > 0 && windowHeight > 0;
+        if (!sceneReady) {
+            timing = false;
+            return;
+        }
+        targetWidth = windowWidth;
+        targetHeight = windowHeight;
+        renderWidth = scaled(targetWidth);
+        renderHeight = scaled(targetHeight);
+        glViewport(0, 0, renderWidth, renderHeight);
+
+        timing = !queryPending[queryIndex];
+        if (timing)
+            glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex].id());
+    }
+
+    void endScene() {
+        if (timing) {
+            glEndQuery(GL_TIME_ELAPSED);
+            queryPending[queryIndex] = true;
+            timing = false;
+        }
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+    }
+
+    // Escala 'sceneColor' (HDR) al framebuffer enlazado sumando el bloom y comprimiendo los
+    // brillos, y ajusta la escala del próximo frame. Sin bloom: bloomTexture = 0.
+    void upscale(GLuint sceneColor, GLuint bloomTexture, float bloomIntensity) {
+        if (!sceneReady)
+            return;  // Sin escena este frame: no se escala una textura vieja
+        sceneReady = false;
+        glViewport(0, 0, targetWidth, targetHeight);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+        shader.use();
+        glm::vec2 uvScale((float)renderWidth / targetWidth, (float)renderHeight / targetHeight);
+        shader.setVec2("uvScale", uvScale);
+        shader.setVec2("texelSize", glm::vec2(1.0f / targetWidth, 1.0f / targetHeight));
+        // Nitidez proporcional a cuánto se está ampliando (nada a escala 1)
+        float amount = settings.minScale < 1.0f ? (1.0f - scale) / (1.0f - settings.minScale) : 0.0f;
+        shader.setFloat("sharpness", settings.sharpness * std::min(std::max(amount, 0.0f), 1.0f));
+        shader.setFloat("bloomIntensity", bloomTexture ? bloomIntensity : 0.0f);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, bloomTexture ? bloomTexture : sceneColor);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, sceneColor);
+        glBindVertexArray(emptyVAO.id());
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glEnable(GL_BLEND);
+        glEnable(GL_DEPTH_TEST);
+
+        collectQueries();
+        frames++;
+        scaleSum += scale;
+        lowestScale = std::min(lowestScale, scale);
+        highestScale = std::max(highestScale, scale);
+    }
+
+    float currentScale() const { return scale; }
+    // Parte usada este frame de una textura de 'size' texels (la escena y los pases que la siguen)
+    int scaled(int size) const { return std::max(1, (int)std::lround(size * scale)); }
+    float gpuMs() const { return smoothedMs; }
+
+    void report() const {
+        if (frames == 0)
+            return;
+        std::printf("Resolucion dinamica: escala prom %.2f (min %.2f, max %.2f, limites %.2f-%.2f) | "
+                    "GPU escena prom %.3f ms, objetivo %.3f ms | %llu cambios de escala\n",
+                    scaleSum / frames, lowestScale, highestScale, settings.minScale, settings.maxScale,
+                    measuredFrames ? measuredMsSum / measuredFrames : 0.0, settings.targetMs,
+                    (unsigned long long)scaleChanges);
+    }
+
+private:
+    static const int QUERY_COUNT = 4;
+
+    Shader shader;
+    GpuVertexArray emptyVAO; // El triángulo de pantalla completa sale de gl_VertexID
+    GpuQuery queries[QUERY_COUNT];
+    bool queryPending[QUERY_COUNT] = {};
+    int queryIndex = 0;
+    bool timing = false;      // Hay una consulta abierta entre beginScene y endScene
+    bool sceneReady = false;  // beginScene dibujó algo que upscale puede escalar
+
+    int targetWidth = 1, targetHeight = 1;   // Ventana (tamaño de las texturas)
+    int renderWidth = 0, renderHeight = 0;   // Parte usada este frame
+    float scale = 1.0f;
+    float smoothedMs = 0.0f;
+
+    uint64_t frames = 0, measuredFrames = 0, scaleChanges = 0;
+    double scaleSum = 0.0, measuredMsSum = 0.0;
+    float lowestScale = 1.0f, highestScale = 0.0f;
+
+    // Lee las consultas terminadas (sin bloquear) y mueve la escala con la más reciente
+    void collectQueries() {
+        float latestMs = -1.0f;
+        for (int i = 0; i < QUERY_COUNT; i++) {
+            int index = (queryIndex + i) % QUERY_COUNT; // De la más vieja a la más nueva
+            if (!queryPending[index])
+                continue;
+            GLuint available = 0;
+            glGetQueryObjectuiv(queries[index].id(), GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                continue;
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[index].id(), GL_QUERY_RESULT, &nanoseconds);
+            queryPending[index] = false;
+            latestMs = (float)(nanoseconds / 1.0e6);
+        }
+        if (latestMs < 0.0f)
+            return;
+
+        measuredFrames++;
+        measuredMsSum += latestMs;
+        smoothedMs = smoothedMs > 0.0f ? glm::mix(smoothedMs, latestMs, 0.2f) : latestMs;
+
+        // Banda muerta alrededor del objetivo para no cambiar de escala cada frame
+        float ratio = settings.targetMs / std::max(smoothedMs, 0.01f);
+        if (ratio > 0.95f && ratio < 1.15f)
+            return;
+        float factor = std::min(std::max(std::sqrt(ratio), 0.9f), 1.05f); // Baja rápido, sube despacio
+        float next = std::min(std::max(scale * factor, settings.minScale), settings.maxScale);
+        if (std::fabs(next - scale) > 0.001f) {
+            scale = next;
+            scaleChanges++;
+        }
+    }
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+// Memoria temporal por frame.
+//
+// LinearArena es un bump allocator: asignar es mover un puntero y liberar todo es poner el
+// puntero en cero. FrameArena tiene una sub-arena por hilo (sin sincronización entre hilos);
+// cada hilo llama beginFrame() al empezar su frame y todo lo que asignó el frame anterior se
+// descarta de golpe. Dentro de una tarea corta (ej. un job) se usa ArenaScope para devolver
+// la memoria al terminar el bloque.
+//
+//   FrameVector<int> visibles;
+//   visibles.reserve(n);   // sin tocar el heap
+//
+// Si una sub-arena se llena, la asignación cae al heap y se cuenta en overflowCount(), así
+// se nota en el reporte que hay que subir la capacidad.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity = 0) { init(capacity); }
+    ~LinearArena() { std::free(base); }
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void init(size_t bytes) {
+        std::free(base);
+        base = bytes ? static_cast<unsigned char*>(std::malloc(bytes)) : nullptr;
+        capacity = base ? bytes : 0;
+        offset = 0;
+    }
+
+    // nullptr si no hay espacio
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t current = reinterpret_cast<uintptr_t>(base) + offset;
+        uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t newOffset = (size_t)(aligned - reinterpret_cast<uintptr_t>(base)) + size;
+        if (newOffset > capacity)
+            return nullptr;
+        offset = newOffset;
+        if (offset > highWater)
+            highWater = offset;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    bool owns(const void* p) const {
+        const unsigned char* c = static_cast<const unsigned char*>(p);
+        return c >= base && c < base + capacity;
+    }
+
+    size_t used() const { return offset; }
+    size_t size() const { return capacity; }
+    size_t peak() const { return highWater; }
+
+    size_t mark() const { return offset; }
+    void rewind(size_t marker) { offset = marker; }
+    void reset() { offset = 0; }
+
+private:
+    unsigned char* base = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t highWater = 0;
+};
+
+class FrameArena {
+public:
+    static constexpr unsigned int MAX_THREADS = 64;
+
+    // Las sub-arenas se reservan una sola vez al inicio
+    static void init(unsigned int threads, size_t bytesPerThread) {
+        FrameArena& a = instance();
+        a.threadCount = threads < MAX_THREADS ? threads : MAX_THREADS;
+        a.arenas.reset(new LinearArena[a.threadCount]);
+        for (unsigned int i = 0; i < a.threadCount; i++)
+            a.arenas[i].init(bytesPerThread);
+    }
+
+    // Sub-arena del hilo que llama (se asigna una la primera vez que el hilo la pide)
+    static LinearArena* current() {
+        static thread_local int slot = -1;
+        FrameArena& a = instance();
+        if (slot < 0)
+            slot = (int)a.nextSlot.fetch_add(1);
+        return slot < (int)a.threadCount ? &a.arenas[slot] : nullptr;
+    }
+
+    static void beginFrame() {
+        if (LinearArena* arena = current())
+            arena->reset();
+    }
+
+    static void* allocate(size_t size, size_t alignment) {
+        LinearArena* arena = current();
+        if (void* p = arena ? arena->allocate(size, alignment) : nullptr)
+            return p;
+        instance().overflows.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    // La memoria de la arena no se libera una por una; sólo los desbordes al heap
+    static void deallocate(void* p) {
+        LinearArena* arena = current();
+        if (arena && arena->owns(p))
+            return;
+        for (unsigned int i = 0; i < instance().threadCount; i++)
+            if (instance().arenas[i].owns(p))
+                return;
+        ::operator delete(p);
+    }
+
+    static uint64_t overflowCount() { return instance().overflows.load(std::memory_order_relaxed); }
+
+    // Mayor uso de memoria visto en cualquier sub-arena
+    static size_t peakBytes() {
+        size_t peak = 0;
+        for (unsigned int i = 0; i < instance().threadCount; i++)
+            if (instance().arenas[i].peak() > peak)
+                peak = instance().arenas[i].peak();
+        return peak;
+    }
+
+private:
+    std::unique_ptr<LinearArena[]> arenas;
+    unsigned int threadCount = 0;
+    std::atomic<unsigned int> nextSlot{0};
+    std::atomic<uint64_t> overflows{0};
+
+    static FrameArena& instance() {
+        static FrameArena arena;
+        return arena;
+    }
+};
+
+// Devuelve la memoria tomada dentro de un bloque a la arena del hilo al salir
+class ArenaScope {
+public:
+    ArenaScope() : arena(FrameArena::current()), marker(arena ? arena->mark() : 0) {}
+    ~ArenaScope() { if (arena) arena->rewind(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    LinearArena* arena;
+    size_t marker;
+};
+
+// Adaptador de allocator para contenedores STL que toman memoria de la FrameArena.
+// Los contenedores deben morir antes del siguiente beginFrame() del mismo hilo.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(FrameArena::allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        FrameArena::deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept { return false; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <iostream>
+
+// Acumula tiempos de frame (en milisegundos) y genera un reporte al final de una corrida
+class FrameStats {
+public:
+    FrameStats(size_t expectedFrames = 1 << 16) {
+        samples.reserve(expectedFrames);
+    }
+
+    void add(double frameMs) {
+        samples.push_back(frameMs);
+    }
+
+    size_t count() const { return samples.size(); }
+
+    // Percentil sobre una copia ordenada (p entre 0 y 1)
+    double percentile(double p) const {
+        if (samples.empty()) return 0.0;
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[idx];
+    }
+
+    void report(const char* title) const {
+        if (samples.empty()) {
+            std::cout << title << ": sin frames" << std::endl;
+            return;
+        }
+        double total = 0.0, minMs = samples[0], maxMs = samples[0];
+        for (double s : samples) {
+            total += s;
+            minMs = std::min(minMs, s);
+            maxMs = std::max(maxMs, s);
+        }
+        double avg = total / samples.size();
+
+        std::printf("%s: %zu frames en %.1f ms\n", title, samples.size(), total);
+        std::printf("  prom %.3f ms (%.1f fps) | min %.3f | p50 %.3f | p95 %.3f | p99 %.3f | max %.3f\n",
+                    avg, 1000.0 / avg, minMs, percentile(0.50), percentile(0.95), percentile(0.99), maxMs);
+    }
+
+    // Un valor por línea, para comparar corridas con otras herramientas
+    bool writeCsv(const std::string& path) const {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            std::cout << "ERROR::FRAME_STATS::NO_SE_PUDO_ESCRIBIR: " << path << std::endl;
+            return false;
+        }
+        std::fprintf(file, "frame,ms\n");
+        for (size_t i = 0; i < samples.size(); i++)
+            std::fprintf(file, "%zu,%.6f\n", i, samples[i]);
+        std::fclose(file);
+        return true;
+    }
+
+private:
+    std::vector<double> samples;
+};
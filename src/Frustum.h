@@ -0,0 +1,35 @@
+#pragma once
+
+// Planos del volumen de vista sacados de projection * view (Gribb & Hartmann). Cada plano
+// apunta hacia adentro: un punto está dentro si dot(plano.xyz, p) + plano.w >= 0 para los 6.
+
+#include <glm/glm.hpp>
+
+struct Frustum {
+    glm::vec4 planes[6]; // izquierda, derecha, abajo, arriba, cerca, lejos
+
+    static Frustum fromMatrix(const glm::mat4& viewProjection) {
+        Frustum f;
+        glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        f.planes[0] = row3 + row0;
+        f.planes[1] = row3 - row0;
+        f.planes[2] = row3 + row1;
+        f.planes[3] = row3 - row1;
+        f.planes[4] = row3 + row2;
+        f.planes[5] = row3 - row2;
+        // Normalizados para que la distancia al plano salga en unidades del mundo
+        for (glm::vec4& plane : f.planes)
+            plane /= glm::length(glm::vec3(plane));
+        return f;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes)
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        return true;
+    }
+};
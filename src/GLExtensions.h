@@ -0,0 +1,101 @@
+#pragma once
+
+// glad se generó sólo para OpenGL 3.3 sin extensiones. Aquí cargamos a mano las funciones
+// opcionales de versiones/extensiones más nuevas que el motor aprovecha si el driver las tiene.
+// Todas las rutas que las usan deben tener un camino alternativo en 3.3 puro.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+
+// --- GL_ARB_get_program_binary (core en 4.1) ---
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH           0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS      0x87FE
+typedef void (APIENTRYP PFN_GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFN_ProgramBinary)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFN_ProgramParameteri)(GLuint program, GLenum pname, GLint value);
+
+// --- GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile ---
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR           0x91B1
+typedef void (APIENTRYP PFN_MaxShaderCompilerThreads)(GLuint count);
+
+// --- GL_ARB_buffer_storage (core en 4.4) ---
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT   0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+typedef void (APIENTRYP PFN_BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// --- GL_ARB_shader_storage_buffer_object (core en 4.3) ---
+#define GL_SHADER_STORAGE_BUFFER                  0x90D2
+#define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
+
+struct GLExtensions {
+    bool programBinary = false;
+    PFN_GetProgramBinary  GetProgramBinary  = nullptr;
+    PFN_ProgramBinary     ProgramBinary     = nullptr;
+    PFN_ProgramParameteri ProgramParameteri = nullptr;
+
+    bool parallelShaderCompile = false;
+    PFN_MaxShaderCompilerThreads MaxShaderCompilerThreads = nullptr;
+
+    bool bufferStorage = false;
+    PFN_BufferStorage BufferStorage = nullptr;
+
+    // Sólo constantes (glBindBufferRange ya está en 3.3); los shaders deben pedir 430
+    bool shaderStorage = false;
+
+    // Versión del contexto (ej. 4.6 -> major 4, minor 6)
+    int major = 3, minor = 3;
+
+    bool atLeast(int maj, int min) const {
+        return major > maj || (major == maj && minor >= min);
+    }
+
+    static bool hasExtension(const char* name) {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (ext && std::strcmp(ext, name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Se llama una vez después de gladLoadGLLoader, con el contexto actual
+    void load() {
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+        if (atLeast(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+            GetProgramBinary  = (PFN_GetProgramBinary)glfwGetProcAddress("glGetProgramBinary");
+            ProgramBinary     = (PFN_ProgramBinary)glfwGetProcAddress("glProgramBinary");
+            ProgramParameteri = (PFN_ProgramParameteri)glfwGetProcAddress("glProgramParameteri");
+            GLint formats = 0;
+            if (GetProgramBinary && ProgramBinary && ProgramParameteri)
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            // Sin formatos binarios el driver no podrá devolvernos nada útil
+            programBinary = formats > 0;
+        }
+
+        if (hasExtension("GL_KHR_parallel_shader_compile"))
+            MaxShaderCompilerThreads = (PFN_MaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        else if (hasExtension("GL_ARB_parallel_shader_compile"))
+            MaxShaderCompilerThreads = (PFN_MaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        parallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+        // 0xFFFFFFFF = que el driver use todos los hilos que quiera
+        if (parallelShaderCompile)
+            MaxShaderCompilerThreads(0xFFFFFFFFu);
+
+        if (atLeast(4, 4) || hasExtension("GL_ARB_buffer_storage"))
+            BufferStorage = (PFN_BufferStorage)glfwGetProcAddress("glBufferStorage");
+        bufferStorage = BufferStorage != nullptr;
+
+        shaderStorage = atLeast(4, 3) || hasExtension("GL_ARB_shader_storage_buffer_object");
+    }
+};
+
+inline GLExtensions glExt;
@@ -0,0 +1,280 @@
+#pragma once
+
+// Dueños de los objetos de OpenGL (búferes, texturas, programas y VAOs).
+//
+// Cada objeto vive en un slot de un pool por tipo y se referencia con un GpuHandle
+// (índice + generación): cuando el slot se reutiliza la generación sube y los handles
+// viejos dejan de resolver en vez de apuntar a otro objeto. Las clases de motor guardan
+// un GpuRef<Tipo>, que cuenta referencias: copiar un Mesh/Shader/Texture comparte el
+// objeto y el último en soltarlo lo manda a borrar.
+//
+// El borrado es diferido: release() sólo encola el nombre (se puede llamar desde cualquier
+// hilo, con o sin contexto) y endFrame(), en el hilo de render, pone un fence al final del
+// frame y borra lo encolado cuando la GPU ya pasó ese fence. Así descargar contenido en
+// tiempo de ejecución no bloquea ni borra algo que un frame en vuelo todavía usa.
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+enum GpuResourceType : uint32_t {
+    GPU_BUFFER,
+    GPU_TEXTURE,
+    GPU_PROGRAM,
+    GPU_VERTEX_ARRAY,
+    GPU_FRAMEBUFFER,
+    GPU_QUERY,
+    GPU_RESOURCE_TYPE_COUNT
+};
+
+struct GpuHandle {
+    uint32_t index = 0;      // 0 = nulo; los slots válidos empiezan en 1
+    uint32_t generation = 0;
+
+    bool valid() const { return index != 0; }
+};
+
+class GpuResources {
+public:
+    // Registra un nombre de OpenGL ya creado; queda con una referencia
+    static GpuHandle adopt(GpuResourceType type, GLuint name) {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        Pool& pool = r.pools[type];
+        uint32_t index;
+        if (!pool.freeSlots.empty()) {
+            index = pool.freeSlots.back();
+            pool.freeSlots.pop_back();
+        } else {
+            index = (uint32_t)pool.slots.size();
+            pool.slots.push_back(Slot());
+        }
+        Slot& slot = pool.slots[index];
+        slot.name = name;
+        slot.refs = 1;
+        pool.live++;
+        return { index, slot.generation };
+    }
+
+    // Nombre de OpenGL del handle, o 0 si ya se liberó (handle viejo)
+    static GLuint resolve(GpuResourceType type, GpuHandle handle) {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        const Slot* slot = r.find(type, handle);
+        return slot ? slot->name : 0;
+    }
+
+    static void addRef(GpuResourceType type, GpuHandle handle) {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (Slot* slot = r.find(type, handle))
+            slot->refs++;
+    }
+
+    // Al llegar a cero el slot se recicla de inmediato y el objeto se encola para borrarse
+    static void release(GpuResourceType type, GpuHandle handle) {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        Slot* slot = r.find(type, handle);
+        if (!slot || --slot->refs > 0)
+            return;
+        r.unfenced.push_back({ type, slot->name });
+        slot->name = 0;
+        slot->generation++;
+        r.pools[type].freeSlots.push_back(handle.index);
+        r.pools[type].live--;
+    }
+
+    // Hilo con el contexto, después de mandar el frame (SwapBuffers)
+    static void endFrame() {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.unfenced.empty()) {
+            r.batches.emplace_back();
+            Batch& batch = r.batches.back();
+            batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            batch.names.swap(r.unfenced);
+        }
+        // Los fences terminan en orden: al primero que no esté listo paramos
+        while (!r.batches.empty()) {
+            Batch& batch = r.batches.front();
+            GLenum status = glClientWaitSync(batch.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+            glDeleteSync(batch.fence);
+            r.destroy(batch.names);
+            r.batches.pop_front();
+        }
+    }
+
+    // Espera a la GPU y borra todo lo pendiente (al cerrar o al descargar un nivel completo)
+    static void flush() {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        glFinish();
+        for (Batch& batch : r.batches) {
+            glDeleteSync(batch.fence);
+            r.destroy(batch.names);
+        }
+        r.batches.clear();
+        r.destroy(r.unfenced);
+    }
+
+    // Crea un objeto vacío del tipo pedido (hilo con el contexto)
+    static GLuint createName(GpuResourceType type) {
+        GLuint name = 0;
+        switch (type) {
+            case GPU_BUFFER:       glGenBuffers(1, &name); break;
+            case GPU_TEXTURE:      glGenTextures(1, &name); break;
+            case GPU_PROGRAM:      name = glCreateProgram(); break;
+            case GPU_VERTEX_ARRAY: glGenVertexArrays(1, &name); break;
+            case GPU_FRAMEBUFFER:  glGenFramebuffers(1, &name); break;
+            case GPU_QUERY:        glGenQueries(1, &name); break;
+            default: break;
+        }
+        return name;
+    }
+
+    static uint32_t liveCount(GpuResourceType type) {
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return r.pools[type].live;
+    }
+
+    static void report() {
+        static const char* const names[] = { "buferes", "texturas", "programas", "VAOs", "framebuffers", "queries" };
+        GpuResources& r = instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        size_t pending = r.unfenced.size();
+        for (const Batch& batch : r.batches)
+            pending += batch.names.size();
+        std::printf("Recursos de GPU:");
+        for (uint32_t t = 0; t < GPU_RESOURCE_TYPE_COUNT; t++)
+            std::printf(" %u %s%s", r.pools[t].live, names[t], t + 1 < GPU_RESOURCE_TYPE_COUNT ? "," : "");
+        std::printf(" | %zu por borrar, %llu borrados\n", pending, (unsigned long long)r.destroyed);
+    }
+
+private:
+    struct Slot {
+        GLuint name = 0;
+        uint32_t generation = 1;
+        uint32_t refs = 0;
+    };
+
+    struct Pool {
+        std::vector<Slot> slots = std::vector<Slot>(1); // El slot 0 queda reservado como nulo
+        std::vector<uint32_t> freeSlots;
+        uint32_t live = 0;
+    };
+
+    struct PendingDelete {
+        GpuResourceType type;
+        GLuint name;
+    };
+
+    // Lo que se liberó en un frame, con el fence que marca cuándo la GPU terminó con él
+    struct Batch {
+        GLsync fence = nullptr;
+        std::vector<PendingDelete> names;
+    };
+
+    std::mutex mutex;
+    Pool pools[GPU_RESOURCE_TYPE_COUNT];
+    std::vector<PendingDelete> unfenced; // Liberados desde el último endFrame()
+    std::deque<Batch> batches;
+    uint64_t destroyed = 0;
+
+    static GpuResources& instance() {
+        static GpuResources resources;
+        return resources;
+    }
+
+    Slot* find(GpuResourceType type, GpuHandle handle) {
+        Pool& pool = pools[type];
+        if (!handle.valid() || handle.index >= pool.slots.size())
+            return nullptr;
+        Slot& slot = pool.slots[handle.index];
+        return slot.generation == handle.generation && slot.refs > 0 ? &slot : nullptr;
+    }
+
+    void destroy(std::vector<PendingDelete>& names) {
+        for (const PendingDelete& p : names) {
+            switch (p.type) {
+                case GPU_BUFFER:       glDeleteBuffers(1, &p.name); break;
+                case GPU_TEXTURE:      glDeleteTextures(1, &p.name); break;
+                case GPU_PROGRAM:      glDeleteProgram(p.name); break;
+                case GPU_VERTEX_ARRAY: glDeleteVertexArrays(1, &p.name); break;
+                case GPU_FRAMEBUFFER:  glDeleteFramebuffers(1, &p.name); break;
+                case GPU_QUERY:        glDeleteQueries(1, &p.name); break;
+                default: break;
+            }
+        }
+        destroyed += names.size();
+        names.clear();
+    }
+};
+
+// Referencia con conteo a un objeto de OpenGL de un tipo fijo
+template <GpuResourceType Type>
+class GpuRef {
+public:
+    GpuRef() = default;
+
+    // Toma posesión de un nombre ya creado (ej. un programa enlazado)
+    static GpuRef adopt(GLuint name) {
+        GpuRef ref;
+        if (name) {
+            ref.handle = GpuResources::adopt(Type, name);
+            ref.name = name;
+        }
+        return ref;
+    }
+
+    static GpuRef generate() { return adopt(GpuResources::createName(Type)); }
+
+    GpuRef(const GpuRef& other) : handle(other.handle), name(other.name) {
+        if (handle.valid())
+            GpuResources::addRef(Type, handle);
+    }
+
+    GpuRef(GpuRef&& other) noexcept : handle(other.handle), name(other.name) {
+        other.handle = GpuHandle();
+        other.name = 0;
+    }
+
+    GpuRef& operator=(GpuRef other) noexcept {
+        std::swap(handle, other.handle);
+        std::swap(name, other.name);
+        return *this;
+    }
+
+    ~GpuRef() { reset(); }
+
+    void reset() {
+        if (handle.valid())
+            GpuResources::release(Type, handle);
+        handle = GpuHandle();
+        name = 0;
+    }
+
+    // El nombre se guarda aquí para no pasar por el pool en cada bind
+    GLuint id() const { return name; }
+    GpuHandle getHandle() const { return handle; }
+    explicit operator bool() const { return name != 0; }
+
+private:
+    GpuHandle handle;
+    GLuint name = 0;
+};
+
+using GpuBuffer      = GpuRef<GPU_BUFFER>;
+using GpuTexture     = GpuRef<GPU_TEXTURE>;
+using GpuProgram     = GpuRef<GPU_PROGRAM>;
+using GpuVertexArray = GpuRef<GPU_VERTEX_ARRAY>;
+using GpuFramebuffer = GpuRef<GPU_FRAMEBUFFER>;
+using GpuQuery       = GpuRef<GPU_QUERY>;
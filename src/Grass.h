@@ -0,0 +1,133 @@
+#pragma once
+
+// Pasto instanciado sobre los chunks del terreno (parte de la simulación; el dibujo está
+// en GrassRenderer.h).
+//
+// Cada chunk del terreno tiene su lista de hojas (GrassBlade, 16 bytes) generada a partir
+// de sus alturas con una secuencia de baja discrepancia (R2): cualquier prefijo de la lista
+// queda repartido parejo por todo el chunk. Así la densidad baja con la distancia sin
+// elegir hojas una por una: de cada chunk sólo se dibujan las primeras 'count' y el
+// vertex shader encoge las que sobran cerca del límite, para que no aparezcan de golpe.
+//
+// buildDraws() toma los chunks del terreno que ya pasaron el frustum, descarta los que
+// quedan fuera de 'range' o detrás de los cerros (OcclusionBuffer) y calcula cuántas hojas
+// necesita cada uno. El resultado es un draw instanciado por chunk cercano.
+
+#include <glm/glm.hpp>
+
+#include "OcclusionCulling.h"
+#include "Terrain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct GrassSettings {
+    float density = 64.0f;         // Hojas por m² donde se dibujan todas
+    float fullRange = 12.0f;       // Hasta esta distancia se dibujan todas
+    float range = 36.0f;           // Desde esta distancia ya no hay pasto
+    float bladeWidth = 0.05f, bladeHeight = 0.5f;
+    glm::vec2 windDirection = glm::vec2(1.0f, 0.3f);
+    float windStrength = 0.35f;    // Inclinación máxima de la punta (en alturas de la hoja)
+    float windSpeed = 1.8f;
+};
+
+// Una hoja: base en el mundo y un valor aleatorio del que salen giro, altura y desfase
+struct GrassBlade {
+    glm::vec3 position;
+    float random;
+};
+
+// Un chunk con pasto para dibujar (lo llena la simulación en el snapshot)
+struct GrassDraw {
+    uint32_t slot;        // Slot del terreno (sus alturas) y serial para saber si cambió
+    uint32_t serial;
+    glm::vec2 origin;
+    uint32_t count;       // Hojas a dibujar (prefijo de la lista del chunk)
+};
+
+class Grass {
+public:
+    GrassSettings settings;
+
+    void init(const GrassSettings& newSettings, float chunkSize) {
+        settings = newSettings;
+        settings.windDirection = glm::normalize(settings.windDirection);
+        blades = std::max(1u, (uint32_t)(settings.density * chunkSize * chunkSize));
+    }
+
+    uint32_t bladesPerChunk() const { return blades; }
+
+    // Fracción de hojas que se dibujan a 'distance' (la misma curva que grass.vert)
+    float density(float distance) const {
+        float t = std::min(std::max((distance - settings.fullRange) / (settings.range - settings.fullRange), 0.0f), 1.0f);
+        return 1.0f - t * t * (3.0f - 2.0f * t);
+    }
+
+    // Hilo de la simulación, con el OcclusionBuffer ya rasterizado
+    void buildDraws(const Terrain& terrain, const std::vector<TerrainDraw>& visibleChunks, const glm::vec3& cameraPos,
+                    OcclusionBuffer& occlusion, std::vector<GrassDraw>& draws) const {
+        draws.clear();
+        for (const TerrainDraw& chunk : visibleChunks) {
+            glm::vec3 boundsMin, boundsMax;
+            terrain.chunkBounds(chunk.slot, boundsMin, boundsMax);
+            boundsMax.y += settings.bladeHeight * 1.4f;
+            float distance = glm::length(glm::max(glm::max(boundsMin - cameraPos, cameraPos - boundsMax), glm::vec3(0.0f)));
+            if (distance >= settings.range || !occlusion.isVisible(boundsMin, boundsMax))
+                continue;
+            GrassDraw draw;
+            draw.slot = chunk.slot;
+            draw.serial = chunk.serial;
+            draw.origin = chunk.origin;
+            draw.count = std::min(blades, (uint32_t)std::ceil(density(distance) * blades));
+            if (draw.count == 0)
+                continue;
+            draws.push_back(draw);
+            bladesDrawn += draw.count;
+        }
+        chunksDrawn += draws.size();
+        frames++;
+    }
+
+    // Reparte 'count' hojas sobre un chunk con las alturas de Terrain::chunkHeights. El
+    // desfase de la secuencia depende del chunk para que los bordes no se vean alineados.
+    static void scatter(const float* chunkHeights, const glm::vec2& origin, float chunkSize, uint32_t count, GrassBlade* out) {
+        uint32_t seed = hash((uint32_t)(int32_t)std::floor(origin.x) * 73856093u ^ (uint32_t)(int32_t)std::floor(origin.y) * 19349663u);
+        double offsetX = (seed & 0xFFFF) / 65536.0, offsetZ = (seed >> 16) / 65536.0;
+        // R2: los dos ejes avanzan con las potencias inversas del número plástico
+        const double a1 = 0.7548776662466927, a2 = 0.5698402909980532;
+        for (uint32_t i = 0; i < count; i++) {
+            double u = offsetX + a1 * (i + 1), v = offsetZ + a2 * (i + 1);
+            u -= std::floor(u);
+            v -= std::floor(v);
+            float gx = (float)u * TERRAIN_CHUNK_QUADS + 1.0f, gz = (float)v * TERRAIN_CHUNK_QUADS + 1.0f;
+            int x0 = std::min((int)gx, TERRAIN_HEIGHT_SIZE - 2), z0 = std::min((int)gz, TERRAIN_HEIGHT_SIZE - 2);
+            float fx = gx - x0, fz = gz - z0;
+            const float* row0 = chunkHeights + z0 * TERRAIN_HEIGHT_SIZE + x0;
+            const float* row1 = row0 + TERRAIN_HEIGHT_SIZE;
+            float top = row0[0] + (row0[1] - row0[0]) * fx;
+            float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+            out[i].position = glm::vec3(origin.x + (float)u * chunkSize, top + (bottom - top) * fz, origin.y + (float)v * chunkSize);
+            out[i].random = (float)(hash(seed + i) & 0xFFFFFF) / (float)0x1000000;
+        }
+    }
+
+    void report() const {
+        if (frames == 0)
+            return;
+        std::printf("Pasto: %u hojas por chunk | por frame: %.1f chunks, %.0f hojas\n", blades,
+                    (double)chunksDrawn / frames, (double)bladesDrawn / frames);
+    }
+
+private:
+    uint32_t blades = 1;
+    mutable uint64_t bladesDrawn = 0, chunksDrawn = 0, frames = 0;
+
+    static uint32_t hash(uint32_t h) {
+        h = (h ^ (h >> 16)) * 0x7feb352du;
+        h = (h ^ (h >> 15)) * 0x846ca68bu;
+        return h ^ (h >> 16);
+    }
+};
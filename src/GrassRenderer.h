@@ -0,0 +1,133 @@
+#pragma once
+
+// Dibuja el pasto de Grass.h (hilo de render).
+//
+// Un búfer de instancias por chunk cercano, en un pool de GRASS_MAX_CHUNKS entradas: cuando
+// aparece un chunk que no está (otro serial), se generan sus hojas con Grass::scatter sobre
+// las alturas del slot y reemplazan a la entrada que lleva más tiempo sin usarse. En estado
+// estable cada chunk es un glDrawArraysInstanced de 'count' hojas; la hoja (5 vértices en
+// tira) se dobla con el viento en grass.vert.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GpuResources.h"
+#include "Grass.h"
+#include "Shader.h"
+#include "Terrain.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+static const int GRASS_MAX_CHUNKS = 64;
+
+class GrassRenderer {
+public:
+    int maxUploadsPerFrame = 4;  // Chunks nuevos por frame (el resto espera al siguiente)
+
+    // Hilo con el contexto. Los búferes se crean todos aquí para no asignar al dibujar.
+    void init(const Grass& grass) {
+        settings = grass.settings;
+        blades = grass.bladesPerChunk();
+        scratch.resize(blades);
+
+        // x: lado (-1 a 1), y: altura (0 a 1); la punta es un solo vértice
+        const float bladeVertices[] = {
+            -1.0f, 0.0f,   1.0f, 0.0f,
+            -0.8f, 0.45f,  0.8f, 0.45f,
+             0.0f, 1.0f,
+        };
+        bladeBuffer = GpuBuffer::generate();
+        glBindBuffer(GL_ARRAY_BUFFER, bladeBuffer.id());
+        glBufferData(GL_ARRAY_BUFFER, sizeof(bladeVertices), bladeVertices, GL_STATIC_DRAW);
+
+        for (Entry& entry : entries) {
+            entry.instances = GpuBuffer::generate();
+            entry.VAO = GpuVertexArray::generate();
+            glBindVertexArray(entry.VAO.id());
+            glBindBuffer(GL_ARRAY_BUFFER, bladeBuffer.id());
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+            glBindBuffer(GL_ARRAY_BUFFER, entry.instances.id());
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)blades * sizeof(GrassBlade), nullptr, GL_STATIC_DRAW);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GrassBlade), (void*)0);
+            glVertexAttribDivisor(1, 1);
+        }
+        glBindVertexArray(0);
+    }
+
+    // 'shader' ya en uso, con los bloques del frame y del objeto enlazados
+    void draw(Shader& shader, const Terrain& terrain, const GrassDraw* draws, size_t count, float time) {
+        frame++;
+        int uploadsLeft = maxUploadsPerFrame;
+        shader.setFloat("time", time);
+        shader.setFloat("bladesPerChunk", (float)blades);
+        shader.setVec2("densityRange", glm::vec2(settings.fullRange, settings.range));
+        shader.setVec2("bladeSize", glm::vec2(settings.bladeWidth, settings.bladeHeight));
+        shader.setVec4("wind", glm::vec4(settings.windDirection, settings.windStrength, settings.windSpeed));
+        // Las hojas se ven por los dos lados
+        glDisable(GL_CULL_FACE);
+        for (size_t i = 0; i < count; i++) {
+            const GrassDraw& draw = draws[i];
+            Entry* entry = find(draw.serial);
+            if (!entry && uploadsLeft > 0) {
+                entry = upload(terrain, draw);
+                uploadsLeft--;
+            }
+            if (!entry)
+                continue;
+            entry->lastUsed = frame;
+            glBindVertexArray(entry->VAO.id());
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 5, (GLsizei)draw.count);
+            drawCalls++;
+            bladesDrawn += draw.count;
+        }
+        glBindVertexArray(0);
+        glEnable(GL_CULL_FACE);
+    }
+
+    void report() const {
+        std::printf("Pasto (render): %llu draws, %llu hojas, %llu chunks generados\n",
+                    (unsigned long long)drawCalls, (unsigned long long)bladesDrawn, (unsigned long long)uploads);
+    }
+
+private:
+    struct Entry {
+        GpuVertexArray VAO;
+        GpuBuffer instances;
+        uint32_t serial = 0;  // 0: vacía (los seriales del terreno empiezan en 1)
+        uint64_t lastUsed = 0;
+    };
+
+    GrassSettings settings;
+    uint32_t blades = 0;
+    GpuBuffer bladeBuffer;
+    Entry entries[GRASS_MAX_CHUNKS];
+    std::vector<GrassBlade> scratch;
+    uint64_t frame = 0, drawCalls = 0, bladesDrawn = 0, uploads = 0;
+
+    Entry* find(uint32_t serial) {
+        for (Entry& entry : entries)
+            if (entry.serial == serial)
+                return &entry;
+        return nullptr;
+    }
+
+    // Reemplaza la entrada usada hace más tiempo; ninguna si todas se usan en este frame
+    Entry* upload(const Terrain& terrain, const GrassDraw& draw) {
+        Entry* oldest = nullptr;
+        for (Entry& entry : entries)
+            if (entry.lastUsed != frame && (!oldest || entry.lastUsed < oldest->lastUsed))
+                oldest = &entry;
+        if (!oldest)
+            return nullptr;
+        Grass::scatter(terrain.chunkHeights(draw.slot), draw.origin, terrain.chunkSize(), blades, scratch.data());
+        glBindBuffer(GL_ARRAY_BUFFER, oldest->instances.id());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)blades * sizeof(GrassBlade), scratch.data());
+        oldest->serial = draw.serial;
+        uploads++;
+        return oldest;
+    }
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <iostream>
+
+// Bits del estado de teclado que usa la simulación (W/S/A/D/SPACE)
+enum InputKey : uint8_t {
+    INPUT_KEY_W     = 1 << 0,
+    INPUT_KEY_S     = 1 << 1,
+    INPUT_KEY_A     = 1 << 2,
+    INPUT_KEY_D     = 1 << 3,
+    INPUT_KEY_SPACE = 1 << 4
+};
+
+// Estado de entrada que consume processInput en lugar de leer GLFW directamente
+struct InputState {
+    uint8_t keys = 0;
+    bool    hasCursor = false; // Hubo movimiento de mouse en este tick
+    float   cursorX = 0.0f;
+
+    bool pressed(InputKey key) const { return (keys & key) != 0; }
+};
+
+// Un evento grabado. En disco se escribe sin padding:
+//   tiempo (uint32, microsegundos) + tipo (uint8) + dato (uint8 tecla o float cursorX)
+struct InputEvent {
+    enum Type : uint8_t { KEY_DOWN = 0, KEY_UP = 1, CURSOR_X = 2, END = 3 };
+
+    uint32_t timeUs;
+    uint8_t  type;
+    uint8_t  key;
+    float    cursorX;
+};
+
+static const char     INPUT_FILE_MAGIC[4] = { 'G', 'K', 'I', 'R' };
+static const uint32_t INPUT_FILE_VERSION  = 1;
+
+// Lee el teclado real de GLFW y lo empaqueta en bits
+inline uint8_t pollKeyboard(GLFWwindow* window) {
+    uint8_t keys = 0;
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)     keys |= INPUT_KEY_W;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)     keys |= INPUT_KEY_S;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)     keys |= INPUT_KEY_A;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)     keys |= INPUT_KEY_D;
+    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) keys |= INPUT_KEY_SPACE;
+    return keys;
+}
+
+// Graba los cambios de teclado y los movimientos del mouse con su tiempo
+class InputRecorder {
+public:
+    void begin(double startTime) {
+        this->startTime = startTime;
+        lastKeys = 0;
+        events.clear();
+        events.reserve(4096);
+    }
+
+    // Se llama una vez por frame con el estado de teclado actual
+    void recordKeys(double now, uint8_t keys) {
+        uint8_t changed = keys ^ lastKeys;
+        for (uint8_t bit = 1; bit != 0 && bit <= INPUT_KEY_SPACE; bit <<= 1) {
+            if (changed & bit)
+                push(now, (keys & bit) ? InputEvent::KEY_DOWN : InputEvent::KEY_UP, bit, 0.0f);
+        }
+        lastKeys = keys;
+    }
+
+    void recordCursor(double now, float x) {
+        push(now, InputEvent::CURSOR_X, 0, x);
+    }
+
+    // Escribe la grabación a disco. El evento END marca la duración total.
+    bool save(const std::string& path, double endTime) {
+        push(endTime, InputEvent::END, 0, 0.0f);
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cout << "ERROR::INPUT::NO_SE_PUDO_ESCRIBIR: " << path << std::endl;
+            return false;
+        }
+        uint32_t count = static_cast<uint32_t>(events.size());
+        std::fwrite(INPUT_FILE_MAGIC, 1, 4, file);
+        std::fwrite(&INPUT_FILE_VERSION, sizeof(uint32_t), 1, file);
+        std::fwrite(&count, sizeof(uint32_t), 1, file);
+        for (const InputEvent& e : events) {
+            std::fwrite(&e.timeUs, sizeof(uint32_t), 1, file);
+            std::fwrite(&e.type, 1, 1, file);
+            if (e.type == InputEvent::CURSOR_X)
+                std::fwrite(&e.cursorX, sizeof(float), 1, file);
+            else
+                std::fwrite(&e.key, 1, 1, file);
+        }
+        std::fclose(file);
+        std::cout << "Entrada grabada: " << count << " eventos en " << path << std::endl;
+        return true;
+    }
+
+private:
+    double startTime = 0.0;
+    uint8_t lastKeys = 0;
+    std::vector<InputEvent> events;
+
+    void push(double now, uint8_t type, uint8_t key, float x) {
+        double t = now - startTime;
+        if (t < 0.0) t = 0.0;
+        InputEvent e;
+        e.timeUs = static_cast<uint32_t>(t * 1000000.0);
+        e.type = type;
+        e.key = key;
+        e.cursorX = x;
+        events.push_back(e);
+    }
+};
+
+// Reproduce una grabación a paso fijo: el tick N corresponde al tiempo N * fixedDelta,
+// así que dos reproducciones del mismo archivo simulan exactamente los mismos pasos.
+class InputReplayer {
+public:
+    float fixedDelta = 1.0f / 60.0f;
+
+    bool load(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            std::cout << "ERROR::INPUT::NO_SE_PUDO_LEER: " << path << std::endl;
+            return false;
+        }
+        char magic[4];
+        uint32_t version = 0, count = 0;
+        bool ok = std::fread(magic, 1, 4, file) == 4 &&
+                  std::fread(&version, sizeof(uint32_t), 1, file) == 1 &&
+                  std::fread(&count, sizeof(uint32_t), 1, file) == 1 &&
+                  std::equal(magic, magic + 4, INPUT_FILE_MAGIC) &&
+                  version == INPUT_FILE_VERSION;
+
+        events.clear();
+        events.reserve(count);
+        for (uint32_t i = 0; ok && i < count; i++) {
+            InputEvent e = {};
+            ok = std::fread(&e.timeUs, sizeof(uint32_t), 1, file) == 1 &&
+                 std::fread(&e.type, 1, 1, file) == 1;
+            if (!ok) break;
+            if (e.type == InputEvent::CURSOR_X)
+                ok = std::fread(&e.cursorX, sizeof(float), 1, file) == 1;
+            else
+                ok = std::fread(&e.key, 1, 1, file) == 1;
+            events.push_back(e);
+        }
+        std::fclose(file);
+
+        if (!ok || events.empty() || events.back().type != InputEvent::END) {
+            std::cout << "ERROR::INPUT::ARCHIVO_INVALIDO: " << path << std::endl;
+            events.clear();
+            return false;
+        }
+        rewind();
+        return true;
+    }
+
+    void rewind() {
+        next = 0;
+        tick = 0;
+        keys = 0;
+    }
+
+    // Avanza un tick y aplica todos los eventos cuyo tiempo ya pasó.
+    // Devuelve false cuando la grabación terminó.
+    bool step(InputState& state) {
+        uint64_t nowUs = static_cast<uint64_t>((double)tick * fixedDelta * 1000000.0);
+        tick++;
+
+        state.hasCursor = false;
+        while (next < events.size() && events[next].timeUs <= nowUs) {
+            const InputEvent& e = events[next++];
+            switch (e.type) {
+            case InputEvent::KEY_DOWN: keys |= e.key; break;
+            case InputEvent::KEY_UP:   keys &= ~e.key; break;
+            case InputEvent::CURSOR_X:
+                state.hasCursor = true;
+                state.cursorX = e.cursorX;
+                break;
+            case InputEvent::END:
+                state.keys = keys;
+                return false;
+            }
+        }
+        state.keys = keys;
+        return true;
+    }
+
+    uint64_t ticks() const { return tick; }
+
+private:
+    std::vector<InputEvent> events;
+    size_t next = 0;
+    uint64_t tick = 0;
+    uint8_t keys = 0;
+};
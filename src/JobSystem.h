@@ -0,0 +1,395 @@
+#pragma once
+
+// Planificador de tareas con robo de trabajo (work stealing).
+//
+// Cada hilo tiene su propia cola Chase-Lev: el dueño mete y saca por abajo (LIFO, caché
+// caliente) y los demás hilos roban por arriba (FIFO) cuando se quedan sin trabajo.
+// Una tarea puede tener un padre; el padre no se considera terminado hasta que terminan
+// todos sus hijos, así que esperar al padre espera a todo el árbol.
+//
+//   Job* root = jobs.create([] {});
+//   for (...) jobs.run(jobs.create([=] { ... }, root));
+//   jobs.run(root);
+//   jobs.wait(root);          // mientras espera, este hilo también ejecuta tareas
+//
+// Con workerCount = 0 no se crean hilos: todo corre en el hilo que llama a wait(), en un
+// orden fijo. Sirve para depurar y para corridas reproducibles.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct Job {
+    static constexpr size_t PAYLOAD_SIZE = 64;
+
+    void (*invoke)(Job&) = nullptr;
+    void (*destroy)(Job&) = nullptr;
+    Job* parent = nullptr;
+    std::atomic<int> unfinished{0};
+    alignas(16) unsigned char payload[PAYLOAD_SIZE];
+};
+
+// Cola de Chase-Lev de capacidad fija (potencia de 2), según Lê et al. 2013
+class WorkStealingQueue {
+public:
+    explicit WorkStealingQueue(size_t capacity = 4096)
+        : mask(capacity - 1), items(new std::atomic<Job*>[capacity]) {}
+
+    // Sólo el dueño
+    bool push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > (int64_t)mask)
+            return false; // llena: quien llama ejecuta la tarea directamente
+        items[b & mask].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Sólo el dueño
+    Job* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = items[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Último elemento: competimos con un posible ladrón
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Cualquier otro hilo
+    Job* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Job* job = items[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? (size_t)(b - t) : 0;
+    }
+
+private:
+    size_t mask;
+    std::unique_ptr<std::atomic<Job*>[]> items;
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+};
+
+class JobSystem {
+public:
+    // Contadores por hilo para ver qué tan ocupados están
+    struct WorkerStats {
+        uint64_t jobsExecuted = 0;
+        uint64_t jobsStolen = 0;
+        uint64_t busyNs = 0;
+        uint64_t idleNs = 0;
+    };
+
+    // workerCount hilos extra además del que crea el JobSystem (slot 0).
+    // externalThreads reserva colas para otros hilos que llamen registerThread().
+    explicit JobSystem(unsigned int workerCount = defaultWorkerCount(), unsigned int externalThreads = 2)
+        : workerCount(workerCount) {
+        unsigned int slots = 1 + workerCount + externalThreads;
+        for (unsigned int i = 0; i < slots; i++)
+            threads.emplace_back(new ThreadData());
+        nextExternal.store(1 + workerCount);
+        threadIndex() = 0;
+        owner() = this;
+
+        for (unsigned int i = 1; i <= workerCount; i++)
+            workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running.store(false);
+        }
+        sleepCondition.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static unsigned int defaultWorkerCount() {
+        unsigned int hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+
+    bool singleThreaded() const { return workerCount == 0; }
+    unsigned int threadCount() const { return 1 + workerCount; }
+
+    // Un hilo que no es worker (ej. el de render) debe registrarse antes de crear tareas
+    bool registerThread() {
+        unsigned int slot = nextExternal.fetch_add(1);
+        if (slot >= threads.size())
+            return false;
+        threadIndex() = slot;
+        owner() = this;
+        return true;
+    }
+
+    // Crea una tarea (todavía no se ejecuta). La función se guarda dentro de la tarea,
+    // sin memoria dinámica, por eso la captura debe caber en Job::PAYLOAD_SIZE.
+    template <typename F>
+    Job* create(F&& function, Job* parent = nullptr) {
+        using Fn = typename std::decay<F>::type;
+        static_assert(sizeof(Fn) <= Job::PAYLOAD_SIZE, "La captura de la tarea es demasiado grande");
+        static_assert(alignof(Fn) <= 16, "La captura de la tarea tiene alineación no soportada");
+
+        Job* job = allocate();
+        new (job->payload) Fn(std::forward<F>(function));
+        job->invoke = [](Job& j) { (*reinterpret_cast<Fn*>(j.payload))(); };
+        job->destroy = [](Job& j) { reinterpret_cast<Fn*>(j.payload)->~Fn(); };
+        job->parent = parent;
+        job->unfinished.store(1, std::memory_order_relaxed);
+        if (parent)
+            parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    void run(Job* job) {
+        if (!current().queue.push(job)) {
+            execute(job, current());
+            return;
+        }
+        if (!singleThreaded() && sleepingWorkers.load(std::memory_order_relaxed) > 0)
+            sleepCondition.notify_one();
+    }
+
+    bool isDone(const Job* job) const {
+        return job->unfinished.load(std::memory_order_acquire) == 0;
+    }
+
+    // Espera a que termine la tarea (y sus hijos) ejecutando otras tareas mientras tanto
+    void wait(const Job* job) {
+        ThreadData& self = current();
+        while (!isDone(job)) {
+            Job* next = findJob(self);
+            if (next)
+                execute(next, self);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // Divide [0, count) en bloques de 'grain' elementos y llama function(begin, end) para
+    // cada bloque en paralelo. Regresa cuando todos los bloques terminaron.
+    template <typename F>
+    void parallel_for(size_t count, size_t grain, const F& function) {
+        if (count == 0)
+            return;
+        // Limitamos la cantidad de bloques para no agotar el anillo de tareas del hilo
+        grain = std::max<size_t>(grain, (count + MAX_PARALLEL_CHUNKS - 1) / MAX_PARALLEL_CHUNKS);
+        if (count <= grain || singleThreaded()) {
+            // No vale la pena repartir: misma semántica, sin colas
+            for (size_t begin = 0; begin < count; begin += grain)
+                function(begin, std::min(begin + grain, count));
+            return;
+        }
+        Job* root = create([] {});
+        const F* fn = &function;
+        for (size_t begin = 0; begin < count; begin += grain) {
+            size_t end = std::min(begin + grain, count);
+            run(create([fn, begin, end] { (*fn)(begin, end); }, root));
+        }
+        run(root);
+        wait(root);
+    }
+
+    WorkerStats stats(unsigned int thread) const {
+        const ThreadData& t = *threads[thread];
+        WorkerStats s;
+        s.jobsExecuted = t.jobsExecuted.load(std::memory_order_relaxed);
+        s.jobsStolen = t.jobsStolen.load(std::memory_order_relaxed);
+        s.busyNs = t.busyNs.load(std::memory_order_relaxed);
+        s.idleNs = t.idleNs.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void resetStats() {
+        for (auto& t : threads) {
+            t->jobsExecuted.store(0);
+            t->jobsStolen.store(0);
+            t->busyNs.store(0);
+            t->idleNs.store(0);
+        }
+    }
+
+    // Utilización de cada worker: tiempo ejecutando tareas / tiempo vivo
+    void reportUtilization() const {
+        std::printf("JobSystem: %u hilos%s\n", threadCount(), singleThreaded() ? " (modo determinista)" : "");
+        for (unsigned int i = 0; i < threads.size(); i++) {
+            WorkerStats s = stats(i);
+            if (i > workerCount && s.jobsExecuted == 0)
+                continue;
+            double total = (double)(s.busyNs + s.idleNs);
+            double utilization = total > 0.0 ? 100.0 * s.busyNs / total : 0.0;
+            std::printf("  hilo %u: %llu tareas (%llu robadas), ocupado %.1f ms",
+                        i, (unsigned long long)s.jobsExecuted, (unsigned long long)s.jobsStolen, s.busyNs / 1e6);
+            if (i >= 1 && i <= workerCount)
+                std::printf(", utilizacion %.1f%%", utilization);
+            std::printf("\n");
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // Tareas sin terminar por hilo que crea: create() reutiliza los slots en anillo y, si el
+    // slot que toca sigue pendiente, ejecuta otras tareas hasta que termine. Por eso una tarea
+    // creada nunca debe quedarse sin run(), y un padre no puede tener más de JOBS_PER_THREAD
+    // hijos creados antes de lanzarlo (parallel_for se limita a MAX_PARALLEL_CHUNKS).
+    static constexpr size_t JOBS_PER_THREAD = 4096;
+    static constexpr size_t MAX_PARALLEL_CHUNKS = 1024;
+
+    struct ThreadData {
+        WorkStealingQueue queue{ JOBS_PER_THREAD };
+        // Anillo de tareas: sólo el dueño asigna, así que no necesita sincronización.
+        // Una tarea se reutiliza tras JOBS_PER_THREAD asignaciones de ese hilo (si ya terminó).
+        std::unique_ptr<Job[]> pool{ new Job[JOBS_PER_THREAD] };
+        size_t nextJob = 0;
+        uint32_t rng = 0x9E3779B9u;
+
+        std::atomic<uint64_t> jobsExecuted{0}, jobsStolen{0}, busyNs{0}, idleNs{0};
+    };
+
+    unsigned int workerCount;
+    std::vector<std::unique_ptr<ThreadData>> threads;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned int> nextExternal{0};
+    std::atomic<bool> running{true};
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<int> sleepingWorkers{0};
+
+    static unsigned int& threadIndex() {
+        static thread_local unsigned int index = 0;
+        return index;
+    }
+    static JobSystem*& owner() {
+        static thread_local JobSystem* system = nullptr;
+        return system;
+    }
+
+    ThreadData& current() {
+        return *threads[owner() == this ? threadIndex() : 0];
+    }
+
+    Job* allocate() {
+        ThreadData& self = current();
+        Job* job = &self.pool[self.nextJob++ & (JOBS_PER_THREAD - 1)];
+        // El anillo dio la vuelta y la tarea anterior de este slot no terminó (por ejemplo,
+        // tareas sueltas que nadie espera): ayudamos a vaciar las colas antes de pisarla
+        while (!isDone(job)) {
+            Job* next = findJob(self);
+            if (next)
+                execute(next, self);
+            else
+                std::this_thread::yield();
+        }
+        job->invoke = nullptr;
+        job->destroy = nullptr;
+        job->parent = nullptr;
+        return job;
+    }
+
+    Job* findJob(ThreadData& self) {
+        if (Job* job = self.queue.pop())
+            return job;
+        if (singleThreaded())
+            return nullptr;
+
+        // Robamos empezando por una víctima pseudoaleatoria para repartir la contención
+        size_t count = threads.size();
+        self.rng ^= self.rng << 13; self.rng ^= self.rng >> 17; self.rng ^= self.rng << 5;
+        size_t start = self.rng % count;
+        for (size_t i = 0; i < count; i++) {
+            ThreadData& victim = *threads[(start + i) % count];
+            if (&victim == &self)
+                continue;
+            if (Job* job = victim.queue.steal()) {
+                self.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void execute(Job* job, ThreadData& self) {
+        Clock::time_point start = Clock::now();
+        job->invoke(*job);
+        job->destroy(*job);
+        finish(job);
+        uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        self.busyNs.fetch_add(ns, std::memory_order_relaxed);
+        self.jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void finish(Job* job) {
+        // El último en terminar (la tarea o su último hijo) avisa al padre. El padre se lee
+        // antes: en cuanto 'unfinished' llega a cero el slot se puede reutilizar.
+        Job* parent = job->parent;
+        if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent)
+            finish(parent);
+    }
+
+    void workerLoop(unsigned int index) {
+        threadIndex() = index;
+        owner() = this;
+        ThreadData& self = *threads[index];
+        int idleSpins = 0;
+
+        while (running.load(std::memory_order_relaxed)) {
+            if (Job* job = findJob(self)) {
+                execute(job, self);
+                idleSpins = 0;
+                continue;
+            }
+
+            Clock::time_point idleStart = Clock::now();
+            if (++idleSpins < 64) {
+                std::this_thread::yield();
+            } else {
+                // Sin trabajo por un rato: dormimos hasta que alguien llame run()
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepingWorkers.fetch_add(1);
+                sleepCondition.wait_for(lock, std::chrono::milliseconds(2));
+                sleepingWorkers.fetch_sub(1);
+                idleSpins = 0;
+            }
+            uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - idleStart).count();
+            self.idleNs.fetch_add(ns, std::memory_order_relaxed);
+        }
+    }
+};
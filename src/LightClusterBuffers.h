@@ -0,0 +1,78 @@
+#pragma once
+
+// Sube el resultado de LightClusterBuilder para la variante CLUSTERED_LIGHTS de basic.frag.
+//
+// Tres texture buffers (GL 3.1, así no hace falta SSBO): luces (RGBA32F), rangos por
+// cluster (RG32UI) e índices (R32UI). Los búferes tienen el tamaño máximo desde el inicio y
+// cada frame se huérfanan con glBufferData(NULL) antes de escribir, para no esperar a que
+// la GPU termine el frame anterior.
+
+#include <glad/glad.h>
+
+#include "GpuResources.h"
+#include "LightClusters.h"
+#include "Shader.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Unidades de textura (0 difusa, 1 y 2 las de VAT)
+static const int CLUSTER_LIGHTS_UNIT = 3;
+static const int CLUSTER_RANGES_UNIT = 4;
+static const int CLUSTER_INDICES_UNIT = 5;
+
+class LightClusterBuffers {
+public:
+    // Hilo con el contexto
+    void init() {
+        create(lightBuffer, lightTexture, GL_RGBA32F, MAX_CLUSTER_LIGHTS * sizeof(PointLight));
+        create(rangeBuffer, rangeTexture, GL_RG32UI, CLUSTER_COUNT * 2 * sizeof(uint32_t));
+        create(indexBuffer, indexTexture, GL_R32UI, MAX_CLUSTER_INDICES * sizeof(uint32_t));
+    }
+
+    // Una vez por shader que use CLUSTERED_LIGHTS
+    static void bindSamplers(Shader& shader) {
+        shader.use();
+        shader.setInt("clusterLights", CLUSTER_LIGHTS_UNIT);
+        shader.setInt("clusterRanges", CLUSTER_RANGES_UNIT);
+        shader.setInt("clusterIndices", CLUSTER_INDICES_UNIT);
+    }
+
+    // Sube los datos del frame y deja las texturas en sus unidades
+    void upload(const LightClusterData& data) {
+        update(lightBuffer, MAX_CLUSTER_LIGHTS * sizeof(PointLight), data.lights.data(), data.lights.size() * sizeof(PointLight));
+        update(rangeBuffer, CLUSTER_COUNT * 2 * sizeof(uint32_t), data.ranges.data(), data.ranges.size() * sizeof(uint32_t));
+        update(indexBuffer, MAX_CLUSTER_INDICES * sizeof(uint32_t), data.indices.data(), data.indices.size() * sizeof(uint32_t));
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_LIGHTS_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, lightTexture.id());
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_RANGES_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, rangeTexture.id());
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_INDICES_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, indexTexture.id());
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+private:
+    GpuBuffer lightBuffer, rangeBuffer, indexBuffer;
+    GpuTexture lightTexture, rangeTexture, indexTexture;
+
+    static void create(GpuBuffer& buffer, GpuTexture& texture, GLenum format, size_t bytes) {
+        buffer = GpuBuffer::generate();
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer.id());
+        glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_DRAW);
+        texture = GpuTexture::generate();
+        glBindTexture(GL_TEXTURE_BUFFER, texture.id());
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer.id());
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    static void update(const GpuBuffer& buffer, size_t capacity, const void* data, size_t bytes) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer.id());
+        glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)capacity, nullptr, GL_STREAM_DRAW);
+        if (bytes > 0)
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, (GLsizeiptr)bytes, data);
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+// Asignación de luces puntuales a clusters (forward clusterizado), sólo CPU.
+//
+// El volumen de vista se parte en una rejilla de CLUSTER_TILES_X x CLUSTER_TILES_Y tiles de
+// pantalla por CLUSTER_SLICES rebanadas de profundidad exponencial (más finas cerca). Cada
+// cluster termina con la lista de luces cuya esfera lo toca, y el fragment shader
+// (CLUSTERED_LIGHTS en basic.frag) sólo recorre la lista de su cluster: cien luces cuestan
+// casi lo mismo que unas pocas mientras no se amontonen en el mismo lugar.
+//
+// build() pasa las luces a espacio de vista de 4 en 4 (SSE, en arreglos separados) y reparte
+// las rebanadas entre los workers: cada tarea prueba 4 luces a la vez contra la profundidad
+// de su rebanada, junta las que la tocan en una lista temporal (FrameArena del hilo) y para
+// cada una calcula el rectángulo de tiles que cubre el corte de la esfera en esa rebanada.
+// Las rebanadas no comparten clusters, así que no hay sincronización; al final las listas
+// se compactan en un solo arreglo para subirlo.
+
+#include <glm/glm.hpp>
+
+#include "FrameArena.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+static const int CLUSTER_TILES_X = 16;
+static const int CLUSTER_TILES_Y = 9;
+static const int CLUSTER_SLICES = 24;
+static const int CLUSTER_COUNT = CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES;
+static const int MAX_CLUSTER_LIGHTS = 1024;       // Luces por frame
+static const int MAX_LIGHTS_PER_CLUSTER = 64;
+static const int MAX_CLUSTER_INDICES = 1 << 16;   // Mínimo que garantiza GL para un texture buffer
+
+// Dos texels RGBA32F por luz (ver clusterLights en basic.frag)
+struct PointLight {
+    glm::vec3 position = glm::vec3(0.0f);
+    float radius = 1.0f;        // Alcance: la luz llega a cero en este radio
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+};
+static_assert(sizeof(PointLight) == 32, "PointLight debe ocupar dos texels RGBA32F");
+
+// Resultado listo para subir (lo llena build(), lo sube LightClusterBuffers)
+struct LightClusterData {
+    std::vector<PointLight> lights;
+    std::vector<uint32_t> ranges;    // Por cluster: primer índice y cantidad
+    std::vector<uint32_t> indices;   // Índices a 'lights', agrupados por cluster
+    float nearDepth = 1.0f;          // La rebanada 0 va de la cámara hasta aquí
+    float farDepth = 100.0f;
+    size_t droppedIndices = 0;       // Luces que no cupieron en su cluster o en el total
+
+    // Rebanada de una profundidad de vista d: log(d) * sliceScale + sliceBias
+    float sliceScale() const { return (float)(CLUSTER_SLICES - 1) / std::log(farDepth / nearDepth); }
+    float sliceBias() const { return 1.0f - std::log(nearDepth) * sliceScale(); }
+};
+
+class LightClusterBuilder {
+public:
+    LightClusterBuilder() {
+        viewX.resize(MAX_CLUSTER_LIGHTS);
+        viewY.resize(MAX_CLUSTER_LIGHTS);
+        depthMin.resize(MAX_CLUSTER_LIGHTS);
+        depthMax.resize(MAX_CLUSTER_LIGHTS);
+        depthCenter.resize(MAX_CLUSTER_LIGHTS);
+        radii.resize(MAX_CLUSTER_LIGHTS);
+        counts.resize(CLUSTER_COUNT);
+        slots.resize((size_t)CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER);
+    }
+
+    // view/projection de la cámara (perspectiva simétrica). Las luces de más se ignoran.
+    void build(const PointLight* lights, size_t count, const glm::mat4& view, const glm::mat4& projection,
+               float nearDepth, float farDepth, JobSystem* jobs, LightClusterData& out) {
+        count = std::min(count, (size_t)MAX_CLUSTER_LIGHTS);
+        lightCount = count;
+        if (out.ranges.capacity() < (size_t)CLUSTER_COUNT * 2) {
+            out.lights.reserve(MAX_CLUSTER_LIGHTS);
+            out.ranges.reserve((size_t)CLUSTER_COUNT * 2);
+            out.indices.reserve(MAX_CLUSTER_INDICES);
+        }
+        out.lights.assign(lights, lights + count);
+        out.nearDepth = nearDepth;
+        out.farDepth = farDepth;
+        projX = projection[0][0];
+        projY = projection[1][1];
+        for (int s = 0; s <= CLUSTER_SLICES; s++)
+            sliceDepth[s] = s == 0 ? 0.0f
+                          : nearDepth * std::pow(farDepth / nearDepth, (float)(s - 1) / (CLUSTER_SLICES - 1));
+        sliceDepth[CLUSTER_SLICES] = 1e30f; // Lo que pase de 'far' cae en la última
+
+        toViewSpace(lights, count, view);
+
+        auto assignSlices = [this](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++)
+                assignSlice((int)s);
+        };
+        if (jobs)
+            jobs->parallel_for(CLUSTER_SLICES, 1, assignSlices);
+        else
+            assignSlices(0, CLUSTER_SLICES);
+
+        // Compactar: rango por cluster y los índices seguidos
+        out.ranges.resize((size_t)CLUSTER_COUNT * 2);
+        out.indices.clear();
+        out.droppedIndices = 0;
+        for (int s = 0; s < CLUSTER_SLICES; s++)
+            out.droppedIndices += sliceDropped[s];
+        for (int c = 0; c < CLUSTER_COUNT; c++) {
+            uint32_t n = counts[c];
+            if (out.indices.size() + n > (size_t)MAX_CLUSTER_INDICES) {
+                out.droppedIndices += n;
+                n = 0;
+            }
+            out.ranges[c * 2] = (uint32_t)out.indices.size();
+            out.ranges[c * 2 + 1] = n;
+            const uint16_t* list = &slots[(size_t)c * MAX_LIGHTS_PER_CLUSTER];
+            for (uint32_t i = 0; i < n; i++)
+                out.indices.push_back(list[i]);
+        }
+        frames++;
+        totalIndices += out.indices.size();
+        totalLights += count;
+        totalDropped += out.droppedIndices;
+    }
+
+    void report() const {
+        if (frames == 0)
+            return;
+        std::printf("Luces clusterizadas (%dx%dx%d): prom %.1f luces y %.1f indices por frame, %llu descartados\n",
+                    CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_SLICES, (double)totalLights / frames,
+                    (double)totalIndices / frames, (unsigned long long)totalDropped);
+    }
+
+private:
+    // Luces en espacio de vista, en arreglos separados (profundidad positiva hacia adelante)
+    std::vector<float> viewX, viewY, depthMin, depthMax, depthCenter, radii;
+    std::vector<uint32_t> counts;   // Luces por cluster
+    std::vector<uint16_t> slots;    // MAX_LIGHTS_PER_CLUSTER por cluster
+    float sliceDepth[CLUSTER_SLICES + 1];
+    float projX = 1.0f, projY = 1.0f;
+    size_t lightCount = 0;
+    uint32_t sliceDropped[CLUSTER_SLICES] = {}; // Una por rebanada: cada tarea escribe la suya
+    uint64_t frames = 0, totalIndices = 0, totalLights = 0, totalDropped = 0;
+
+    void toViewSpace(const PointLight* lights, size_t count, const glm::mat4& view) {
+        // Fila por componente: x' = v[0][0]*x + v[1][0]*y + v[2][0]*z + v[3][0]
+        const __m128 m00 = _mm_set1_ps(view[0][0]), m10 = _mm_set1_ps(view[1][0]), m20 = _mm_set1_ps(view[2][0]), m30 = _mm_set1_ps(view[3][0]);
+        const __m128 m01 = _mm_set1_ps(view[0][1]), m11 = _mm_set1_ps(view[1][1]), m21 = _mm_set1_ps(view[2][1]), m31 = _mm_set1_ps(view[3][1]);
+        const __m128 m02 = _mm_set1_ps(view[0][2]), m12 = _mm_set1_ps(view[1][2]), m22 = _mm_set1_ps(view[2][2]), m32 = _mm_set1_ps(view[3][2]);
+        const __m128 farAway = _mm_set1_ps(-1e30f);
+        for (size_t i = 0; i < count; i += 4) {
+            // Último bloque incompleto: las luces que faltan quedan infinitamente atrás
+            alignas(16) float px[4], py[4], pz[4], pr[4];
+            for (size_t k = 0; k < 4; k++) {
+                bool valid = i + k < count;
+                const PointLight& light = lights[valid ? i + k : 0];
+                px[k] = light.position.x;
+                py[k] = light.position.y;
+                pz[k] = light.position.z;
+                pr[k] = valid ? light.radius : -1.0f;
+            }
+            __m128 x = _mm_load_ps(px), y = _mm_load_ps(py), z = _mm_load_ps(pz), r = _mm_load_ps(pr);
+            __m128 vx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_add_ps(_mm_mul_ps(m20, z), m30));
+            __m128 vy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_add_ps(_mm_mul_ps(m21, z), m31));
+            __m128 vz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_add_ps(_mm_mul_ps(m22, z), m32));
+            __m128 depth = _mm_sub_ps(_mm_setzero_ps(), vz);
+            __m128 invalid = _mm_cmplt_ps(r, _mm_setzero_ps());
+            __m128 lo = _mm_sub_ps(depth, r), hi = _mm_add_ps(depth, r);
+            // Una luz inválida nunca toca una rebanada: [-inf, -inf]
+            lo = _mm_or_ps(_mm_and_ps(invalid, farAway), _mm_andnot_ps(invalid, lo));
+            hi = _mm_or_ps(_mm_and_ps(invalid, farAway), _mm_andnot_ps(invalid, hi));
+            storeBlock(viewX, i, vx, count);
+            storeBlock(viewY, i, vy, count);
+            storeBlock(depthCenter, i, depth, count);
+            storeBlock(depthMin, i, lo, count);
+            storeBlock(depthMax, i, hi, count);
+            storeBlock(radii, i, r, count);
+        }
+    }
+
+    static void storeBlock(std::vector<float>& stream, size_t i, __m128 value, size_t count) {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, value);
+        for (size_t k = 0; k < 4 && i + k < count; k++)
+            stream[i + k] = lanes[k];
+    }
+
+    void assignSlice(int slice) {
+        const float z0 = sliceDepth[slice], z1 = sliceDepth[slice + 1];
+        uint32_t* sliceCounts = &counts[(size_t)slice * CLUSTER_TILES_X * CLUSTER_TILES_Y];
+        std::fill(sliceCounts, sliceCounts + CLUSTER_TILES_X * CLUSTER_TILES_Y, 0u);
+        sliceDropped[slice] = 0;
+
+        // Luces que tocan la rebanada; la memoria vuelve a la arena del hilo al terminar
+        ArenaScope scope;
+        FrameVector<uint32_t> touching;
+        touching.reserve(lightCount);
+
+        const __m128 sliceNear = _mm_set1_ps(z0), sliceFar = _mm_set1_ps(z1);
+        for (size_t i = 0; i < lightCount; i += 4) {
+            // 4 luces a la vez: ¿su rango de profundidad toca esta rebanada?
+            alignas(16) float lo[4] = { -1e30f, -1e30f, -1e30f, -1e30f }, hi[4] = { -1e30f, -1e30f, -1e30f, -1e30f };
+            for (size_t k = 0; k < 4 && i + k < lightCount; k++) {
+                lo[k] = depthMin[i + k];
+                hi[k] = depthMax[i + k];
+            }
+            int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(_mm_load_ps(lo), sliceFar),
+                                                  _mm_cmpgt_ps(_mm_load_ps(hi), sliceNear)));
+            while (mask) {
+                int k = 0;
+                while (!(mask & (1 << k)))
+                    k++;
+                mask &= ~(1 << k);
+                touching.push_back((uint32_t)(i + k));
+            }
+        }
+        for (uint32_t light : touching)
+            addToSlice(slice, light, z0, z1, sliceCounts);
+    }
+
+    void addToSlice(int slice, uint32_t light, float z0, float z1, uint32_t* sliceCounts) {
+        // Corte de la esfera dentro de la rebanada: radio máximo en la profundidad más
+        // cercana al centro, entre las profundidades que de verdad ocupa
+        float d = depthCenter[light], r = radii[light];
+        float closest = std::min(std::max(d, z0), z1);
+        float crossRadius = std::sqrt(std::max(r * r - (d - closest) * (d - closest), 0.0f));
+        float zNear = std::max(std::max(z0, d - r), 0.05f);
+        float zFar = std::max(std::min(z1, d + r), zNear);
+
+        // x / profundidad es monótono en cada variable: los extremos salen de las esquinas
+        int tx0, tx1, ty0, ty1;
+        tileRange(viewX[light], crossRadius, zNear, zFar, projX, CLUSTER_TILES_X, tx0, tx1);
+        tileRange(viewY[light], crossRadius, zNear, zFar, projY, CLUSTER_TILES_Y, ty0, ty1);
+        if (tx0 > tx1 || ty0 > ty1)
+            return;
+
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                int local = ty * CLUSTER_TILES_X + tx;
+                uint32_t& n = sliceCounts[local];
+                if (n >= (uint32_t)MAX_LIGHTS_PER_CLUSTER) {
+                    sliceDropped[slice]++;
+                    continue;
+                }
+                size_t cluster = (size_t)slice * CLUSTER_TILES_X * CLUSTER_TILES_Y + local;
+                slots[cluster * MAX_LIGHTS_PER_CLUSTER + n++] = (uint16_t)light;
+            }
+        }
+    }
+
+    static void tileRange(float center, float radius, float zNear, float zFar, float proj, int tiles, int& first, int& last) {
+        float a = (center - radius) * proj, b = (center + radius) * proj;
+        float lo = std::min(a / zNear, a / zFar), hi = std::max(b / zNear, b / zFar);
+        if (hi < -1.0f || lo > 1.0f) {
+            first = 1;
+            last = 0;
+            return;
+        }
+        first = std::max(0, (int)std::floor((lo * 0.5f + 0.5f) * tiles));
+        last = std::min(tiles - 1, (int)std::floor((hi * 0.5f + 0.5f) * tiles));
+    }
+};
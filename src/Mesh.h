@@ -4,54 +4,122 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "GpuResources.h"
 #include "Shader.h"
 #include "Vertex.h"
 
 // Un struct simple para guardar la info de la textura
 struct Texture {
-    unsigned int id;
+    GpuTexture handle;  // Compartida (con conteo de referencias) entre las mallas que la usan
     std::string type; // ej. "texture_diffuse" o "texture_specular"
     std::string path; // guardamos la ruta para comparar con otras texturas cargadas
 };
 
+// Qué geometría se queda en memoria de CPU después de subirla a la GPU
+enum GeometryRetention {
+    GEOMETRY_KEEP_ALL,       // Vértices e índices completos (como antes)
+    GEOMETRY_POSITIONS_ONLY, // Sólo posiciones + índices, suficiente para picking
+    GEOMETRY_DROP            // Nada: la malla sólo vive en la GPU
+};
+
 class Mesh {
 public:
     // Datos de la malla
     std::vector<Vertex>       vertices;
     std::vector<unsigned int> indices;
+    std::vector<glm::vec3>    positions;    // Sólo con GEOMETRY_POSITIONS_ONLY
     std::vector<Texture>      textures;
-    unsigned int VAO;
+    std::vector<std::string>  samplerNames; // "texture_diffuse1", ... uno por textura
+    GpuVertexArray VAO;
+    unsigned int indexCount = 0;            // Lo que se dibuja, aunque se liberen los índices
+    size_t       gpuBytes = 0;              // Tamaño de VBO + EBO
+
+    // Constructor: recibe los vectores por valor para que quien llama pueda moverlos
+    // (std::move) y no se copie la geometría en ningún paso
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
+        : vertices(std::move(vertices)), indices(std::move(indices)), textures(std::move(textures)) {
 
-    // Constructor
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) {
-        this->vertices = vertices;
-        this->indices = indices;
-        this->textures = textures;
+        // Los nombres de los samplers no cambian: los armamos una sola vez aquí y no en cada Draw
+        buildSamplerNames();
 
         // Ahora configuramos los búferes de OpenGL
         setupMesh();
     }
 
+    // Una Mesh es dueña de sus búferes de OpenGL (se borran al destruirla): se puede mover
+    // pero no copiar
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&&) noexcept = default;
+    Mesh& operator=(Mesh&&) noexcept = default;
+
+    // Libera la copia de CPU según la política (los datos ya están en la GPU)
+    void releaseGeometry(GeometryRetention retention) {
+        if (retention == GEOMETRY_KEEP_ALL)
+            return;
+        if (retention == GEOMETRY_POSITIONS_ONLY) {
+            positions.reserve(vertices.size());
+            for (const Vertex& v : vertices)
+                positions.push_back(v.Position);
+        } else {
+            std::vector<unsigned int>().swap(indices);
+        }
+        std::vector<Vertex>().swap(vertices);
+    }
+
+    // Bytes de geometría que siguen en memoria de CPU
+    size_t cpuBytes() const {
+        return vertices.capacity() * sizeof(Vertex)
+             + indices.capacity() * sizeof(unsigned int)
+             + positions.capacity() * sizeof(glm::vec3);
+    }
+
     // Función para dibujar la malla
     // <--- 2. CORREGIDO: Recibe el Shader por referencia
     void Draw(Shader &shader) {
         // --- Lógica de Texturas ---
         // Asignamos las texturas a las unidades correspondientes antes de dibujar
+        for(unsigned int i = 0; i < textures.size(); i++)
+        {
+            glActiveTexture(GL_TEXTURE0 + i); // Activar unidad de textura apropiada
+
+            // Configurar el sampler en el shader (ej. glUniform1i)
+            shader.setInt(samplerNames[i].c_str(), i);
+            
+            // Vincular la textura
+            glBindTexture(GL_TEXTURE_2D, textures[i].handle.id());
+        }
+        
+        // Dibujar malla
+        glBindVertexArray(VAO.id());
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+
+        // Buenas prácticas: regresar a la textura 0
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+private:
+    // IDs de los búferes de OpenGL
+    GpuBuffer VBO, EBO;
+
+    void buildSamplerNames() {
         unsigned int diffuseNr  = 1;
         unsigned int specularNr = 1;
         unsigned int normalNr   = 1;
         unsigned int heightNr   = 1;
 
+        samplerNames.clear();
         for(unsigned int i = 0; i < textures.size(); i++)
         {
-            glActiveTexture(GL_TEXTURE0 + i); // Activar unidad de textura apropiada
-            
             // Recuperar el número de textura (diffuse_textureN)
             std::string number;
-            std::string name = textures[i].type;
+            const std::string &name = textures[i].type;
             
             if(name == "texture_diffuse")
                 number = std::to_string(diffuseNr++);
@@ -62,44 +130,31 @@ public:
              else if(name == "texture_height")
                 number = std::to_string(heightNr++);
 
-            // Configurar el sampler en el shader (ej. glUniform1i)
-            shader.setInt((name + number).c_str(), i);
-            
-            // Vincular la textura
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            samplerNames.push_back(name + number);
         }
-        
-        // Dibujar malla
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-
-        // Buenas prácticas: regresar a la textura 0
-        glActiveTexture(GL_TEXTURE0);
     }
 
-private:
-    // IDs de los búferes de OpenGL
-    unsigned int VBO, EBO;
-
     // Función de configuración
     void setupMesh() {
         // 1. Crear búferes
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+        VAO = GpuVertexArray::generate();
+        VBO = GpuBuffer::generate();
+        EBO = GpuBuffer::generate();
 
-        glBindVertexArray(VAO);
+        glBindVertexArray(VAO.id());
 
         // 2. Cargar datos en el VBO
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO.id());
         // Struct memory layout es secuencial, podemos pasar el puntero al primer elemento
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
 
         // 3. Cargar datos en el EBO
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.id());
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
+        indexCount = static_cast<unsigned int>(indices.size());
+        gpuBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+
         // 4. Configurar punteros de atributos (Layouts del Vertex Shader)
         
         // Posición (location = 0)
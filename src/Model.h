@@ -9,7 +9,9 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "AnimationClip.h"
 #include "Mesh.h"
+#include "SceneGraph.h"
 #include "Shader.h"
 
 #include <string>
@@ -19,52 +21,148 @@
 #include <map>
 #include <vector>
 
+// Imagen ya decodificada en memoria, lista para subirse a OpenGL
+struct ImageData {
+    int width = 0, height = 0, nrComponents = 0;
+    unsigned char *pixels = nullptr;
+    std::string filename;
+};
+
 // Función auxiliar para cargar texturas desde archivo
-unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma = false);
+GpuTexture TextureFromFile(const char *path, const std::string &directory, bool gamma = false);
+// Las dos mitades de TextureFromFile: decodificar (sólo CPU, se puede llamar desde
+// cualquier hilo) y subir a la GPU (hilo con el contexto OpenGL; libera los pixeles)
+ImageData loadImageData(const char *path, const std::string &directory);
+GpuTexture uploadTexture(ImageData &image);
 
 class Model {
 public:
+    // Una malla colgada de un nodo de la jerarquía del archivo (una malla puede aparecer en
+    // varios nodos y se sube a la GPU una sola vez)
+    struct MeshInstance {
+        uint32_t mesh; // Índice en meshes
+        uint32_t node; // Índice en nodes
+    };
+
     std::vector<Texture> textures_loaded;	// Para evitar cargar la misma textura muchas veces
     std::vector<Mesh>    meshes;
+    SceneGraph           nodes;             // Jerarquía de aiNode con sus mTransformation
+    std::vector<MeshInstance> instances;
+    std::vector<CompressedAnimationClip> animations; // Clips del archivo, ya comprimidos
     std::string          directory;
     bool                 gammaCorrection;
+    GeometryRetention    retention;        // Qué geometría de CPU conservar después de upload()
 
-    Model(std::string const &path, bool gamma = false) : gammaCorrection(gamma) {
-        loadModel(path);
-    }
+    Model(bool gamma = false, GeometryRetention retention = GEOMETRY_KEEP_ALL)
+        : gammaCorrection(gamma), retention(retention) {}
 
-    void Draw(Shader &shader) {
-        for(unsigned int i = 0; i < meshes.size(); i++)
-            meshes[i].Draw(shader);
+    Model(std::string const &path, bool gamma = false, GeometryRetention retention = GEOMETRY_KEEP_ALL)
+        : gammaCorrection(gamma), retention(retention) {
+        if (import(path))
+            upload();
     }
 
-private:
-    void loadModel(std::string const &path) {
+    // Los meshes son dueños de búferes de OpenGL: el modelo tampoco se copia
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&&) = default;
+    Model& operator=(Model&&) = default;
+
+    // Carga en dos fases: import() hace todo el trabajo de CPU (Assimp, geometría,
+    // decodificar texturas) y puede correr en un worker; upload() crea los objetos de
+    // OpenGL y debe llamarse desde el hilo con el contexto.
+    bool import(std::string const &path) {
         Assimp::Importer importer;
         const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
             std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
-            return;
+            return false;
         }
         directory = path.substr(0, path.find_last_of('/'));
-        processNode(scene->mRootNode, scene);
+        std::vector<int> meshIndices(scene->mNumMeshes, -1);
+        processNode(scene->mRootNode, scene, SceneGraph::NO_PARENT, meshIndices);
+        nodes.update();
+
+        // Las llaves de Assimp no se guardan: se comprimen aquí, todavía en el worker
+        animations.reserve(scene->mNumAnimations);
+        for (unsigned int i = 0; i < scene->mNumAnimations; i++)
+            animations.push_back(CompressedAnimationClip::compress(RawAnimationClip::fromAssimp(scene->mAnimations[i])));
+        return true;
     }
 
-    void processNode(aiNode *node, const aiScene *scene) {
-        for(unsigned int i = 0; i < node->mNumMeshes; i++) {
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
+    void upload() {
+        for (unsigned int i = 0; i < textures_loaded.size(); i++)
+            textures_loaded[i].handle = uploadTexture(pendingImages[i]);
+        pendingImages.clear();
+
+        meshes.reserve(meshes.size() + pendingMeshes.size());
+        for (PendingMesh &pending : pendingMeshes) {
+            std::vector<Texture> textures;
+            textures.reserve(pending.textureIndices.size());
+            for (unsigned int t : pending.textureIndices)
+                textures.push_back(textures_loaded[t]);
+            meshes.emplace_back(std::move(pending.vertices), std::move(pending.indices), std::move(textures));
+            meshes.back().releaseGeometry(retention);
         }
-        for(unsigned int i = 0; i < node->mNumChildren; i++) {
-            processNode(node->mChildren[i], scene);
+        std::vector<PendingMesh>().swap(pendingMeshes);
+    }
+
+    // Bytes de geometría que el modelo mantiene en CPU y los que subió a la GPU
+    size_t cpuBytes() const {
+        size_t bytes = 0;
+        for (const Mesh &mesh : meshes)
+            bytes += mesh.cpuBytes();
+        return bytes;
+    }
+
+    size_t gpuBytes() const {
+        size_t bytes = 0;
+        for (const Mesh &mesh : meshes)
+            bytes += mesh.gpuBytes;
+        return bytes;
+    }
+
+    size_t animationBytes() const {
+        size_t bytes = 0;
+        for (const CompressedAnimationClip &clip : animations)
+            bytes += clip.bytes();
+        return bytes;
+    }
+
+    void printMemoryReport(const char *name) const {
+        static const char* const policies[] = { "KEEP_ALL", "POSITIONS_ONLY", "DROP" };
+        std::cout << "[Memoria] " << name << ": " << meshes.size() << " mallas, politica " << policies[retention]
+                  << " | CPU " << cpuBytes() / 1024 << " KB retenidos"
+                  << " | GPU " << gpuBytes() / 1024 << " KB"
+                  << " | " << animations.size() << " animaciones, " << animationBytes() / 1024 << " KB" << std::endl;
+        for (const CompressedAnimationClip &clip : animations)
+            clip.report();
+    }
+
+    // Dibuja cada instancia con su matriz de mundo (parent * nodo). setTransform(mundo) debe
+    // dejar esa matriz lista para el shader antes de cada malla.
+    template <typename SetTransform>
+    void Draw(Shader &shader, const glm::mat4 &parent, SetTransform setTransform) {
+        for (const MeshInstance &instance : instances) {
+            setTransform(parent * nodes.world(instance.node));
+            meshes[instance.mesh].Draw(shader);
         }
     }
 
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene) {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-        std::vector<Texture> textures;
+    static glm::mat4 toGlm(const aiMatrix4x4 &m) {
+        // aiMatrix4x4 está por filas y glm por columnas
+        return glm::mat4(m.a1, m.b1, m.c1, m.d1,
+                         m.a2, m.b2, m.c2, m.d2,
+                         m.a3, m.b3, m.c3, m.d3,
+                         m.a4, m.b4, m.c4, m.d4);
+    }
+
+    // Parte de CPU de processMesh: copia vértices e índices de Assimp a nuestro formato
+    static void extractGeometry(const aiMesh *mesh, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices) {
+        // Con aiProcess_Triangulate cada cara tiene 3 índices
+        vertices.reserve(vertices.size() + mesh->mNumVertices);
+        indices.reserve(indices.size() + (size_t)mesh->mNumFaces * 3);
 
         for(unsigned int i = 0; i < mesh->mNumVertices; i++) {
             Vertex vertex;
@@ -97,26 +195,57 @@ private:
         }
 
         for(unsigned int i = 0; i < mesh->mNumFaces; i++) {
-            aiFace face = mesh->mFaces[i];
+            const aiFace &face = mesh->mFaces[i];
             for(unsigned int j = 0; j < face.mNumIndices; j++)
                 indices.push_back(face.mIndices[j]);
         }
+    }
+
+private:
+    // Malla importada que todavía no tiene búferes de OpenGL
+    struct PendingMesh {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<unsigned int> textureIndices; // Índices en textures_loaded
+    };
+    std::vector<PendingMesh> pendingMeshes;
+    std::vector<ImageData>   pendingImages; // Paralelo a textures_loaded hasta upload()
+
+    // meshIndices: para cada malla de Assimp, su índice en pendingMeshes (-1 si aún no se procesó)
+    void processNode(aiNode *node, const aiScene *scene, uint32_t parent, std::vector<int> &meshIndices) {
+        if (node == scene->mRootNode)
+            pendingMeshes.reserve(scene->mNumMeshes);
+        uint32_t nodeIndex = nodes.addNode(parent, toGlm(node->mTransformation));
+        for(unsigned int i = 0; i < node->mNumMeshes; i++) {
+            unsigned int sceneMesh = node->mMeshes[i];
+            if (meshIndices[sceneMesh] < 0) {
+                meshIndices[sceneMesh] = (int)pendingMeshes.size();
+                pendingMeshes.push_back(processMesh(scene->mMeshes[sceneMesh], scene));
+            }
+            instances.push_back({ (uint32_t)meshIndices[sceneMesh], nodeIndex });
+        }
+        for(unsigned int i = 0; i < node->mNumChildren; i++) {
+            processNode(node->mChildren[i], scene, nodeIndex, meshIndices);
+        }
+    }
+
+    PendingMesh processMesh(aiMesh *mesh, const aiScene *scene) {
+        PendingMesh pending;
+
+        extractGeometry(mesh, pending.vertices, pending.indices);
 
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];    
 
         // 1. Mapas difusos (Textura base)
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", pending.textureIndices);
         
         // 2. Mapas especulares (Brillo)
-        std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", pending.textureIndices);
 
-        return Mesh(vertices, indices, textures);
+        return pending;
     }
 
-    std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) {
-        std::vector<Texture> textures;
+    void loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName, std::vector<unsigned int> &textureIndices) {
         for(unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
             aiString str;
             mat->GetTexture(type, i, &str);
@@ -124,25 +253,30 @@ private:
             bool skip = false;
             for(unsigned int j = 0; j < textures_loaded.size(); j++) {
                 if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-                    textures.push_back(textures_loaded[j]);
+                    textureIndices.push_back(j);
                     skip = true; 
                     break;
                 }
             }
             if(!skip) {   
                 Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                // texture.handle se asigna en upload()
                 texture.type = typeName;
                 texture.path = str.C_Str();
-                textures.push_back(texture);
+                textureIndices.push_back(static_cast<unsigned int>(textures_loaded.size()));
                 textures_loaded.push_back(texture); 
+                pendingImages.push_back(loadImageData(str.C_Str(), this->directory));
             }
         }
-        return textures;
     }
 };
 
-unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma) {
+GpuTexture TextureFromFile(const char *path, const std::string &directory, bool gamma) {
+    ImageData image = loadImageData(path, directory);
+    return uploadTexture(image);
+}
+
+ImageData loadImageData(const char *path, const std::string &directory) {
     std::string filename = std::string(path);
 
     // --- CORRECCIÓN DE RUTA ---
@@ -154,26 +288,28 @@ unsigned int TextureFromFile(const char *path, const std::string &directory, boo
     }
     // ---------------------------
 
-    filename = directory + '/' + filename;
+    ImageData image;
+    image.filename = directory + '/' + filename;
+    // Cargar la imagen
+    image.pixels = stbi_load(image.filename.c_str(), &image.width, &image.height, &image.nrComponents, 0);
+    return image;
+}
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+GpuTexture uploadTexture(ImageData &image) {
+    GpuTexture texture = GpuTexture::generate();
 
-    int width, height, nrComponents;
-    // Cargar la imagen
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    
+    unsigned char *data = image.pixels;
     if (data) {
         GLenum format;
-        if (nrComponents == 1)
+        if (image.nrComponents == 1)
             format = GL_RED;
-        else if (nrComponents == 3)
+        else if (image.nrComponents == 3)
             format = GL_RGB;
-        else if (nrComponents == 4)
+        else if (image.nrComponents == 4)
             format = GL_RGBA;
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glBindTexture(GL_TEXTURE_2D, texture.id());
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
 
         // Configuración de repetición y filtrado (importante para que se vea bien)
@@ -184,9 +320,9 @@ unsigned int TextureFromFile(const char *path, const std::string &directory, boo
 
         stbi_image_free(data);
     } else {
-        std::cout << "Texture failed to load at path: " << filename << std::endl;
-        stbi_image_free(data);
+        std::cout << "Texture failed to load at path: " << image.filename << std::endl;
     }
+    image.pixels = nullptr;
 
-    return textureID;
+    return texture;
 }
\ No newline at end of file
@@ -0,0 +1,335 @@
+#pragma once
+
+// Culling por oclusión en CPU.
+//
+// Los oclusores (mallas simplificadas: cajas, el terreno a baja resolución) se rasterizan
+// a un búfer de profundidad chico (256x128 por defecto) y después se prueba la caja de cada
+// objeto contra ese búfer. Todo corre en la CPU, sin contexto de OpenGL.
+//
+//   1. addOccluder(): transforma los vértices (SSE, 4 componentes a la vez), descarta los
+//      triángulos de espaldas o que cruzan el plano cercano (quitar oclusores nunca oculta
+//      algo visible), prepara las ecuaciones de aristas y el plano de profundidad, y anota
+//      el triángulo en cada tile de 32x32 que toca.
+//   2. rasterize(): un tile por tarea; cada tarea recorre sus triángulos 4 píxeles a la vez
+//      (SSE) guardando la profundidad más cercana, y al final llena el nivel jerárquico:
+//      la profundidad más lejana de cada bloque de 8x8.
+//   3. isVisible(): proyecta la caja, toma su profundidad más cercana y recorre los bloques
+//      que cubre; sólo baja a los píxeles de un bloque si el bloque no la tapa entero.
+//
+// La profundidad es z/w llevada a [0, 1] (1 = lejos), con y hacia arriba como en NDC.
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+// Malla de oclusión: pocos triángulos, en sentido antihorario visto desde afuera
+struct OccluderMesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+
+    // Caja centrada en el origen con la base en y = 0 (paredes, columnas, edificios)
+    static OccluderMesh box(const glm::vec3& halfExtents) {
+        OccluderMesh mesh;
+        const glm::vec3 h = halfExtents;
+        for (int i = 0; i < 8; i++)
+            mesh.vertices.push_back(glm::vec3((i & 1) ? h.x : -h.x, (i & 2) ? 2.0f * h.y : 0.0f, (i & 4) ? h.z : -h.z));
+        static const uint32_t faces[36] = {
+            0, 4, 6,  0, 6, 2,   // -x
+            1, 3, 7,  1, 7, 5,   // +x
+            0, 1, 5,  0, 5, 4,   // -y
+            2, 6, 7,  2, 7, 3,   // +y
+            0, 2, 3,  0, 3, 1,   // -z
+            4, 5, 7,  4, 7, 6    // +z
+        };
+        mesh.indices.assign(faces, faces + 36);
+        return mesh;
+    }
+};
+
+class OcclusionBuffer {
+public:
+    static constexpr int TILE_SIZE = 32;
+    static constexpr int BLOCK_SIZE = 8;
+
+    OcclusionBuffer(int requestedWidth = 256, int requestedHeight = 128) {
+        // Múltiplos del tile: las filas quedan alineadas a 16 bytes para las cargas SSE
+        width = std::max(TILE_SIZE, (requestedWidth + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE);
+        height = std::max(TILE_SIZE, (requestedHeight + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE);
+        tilesX = width / TILE_SIZE;
+        tilesY = height / TILE_SIZE;
+        blocksX = width / BLOCK_SIZE;
+        depth = static_cast<float*>(_mm_malloc((size_t)width * height * sizeof(float), 16));
+        blockDepth.assign((size_t)blocksX * (height / BLOCK_SIZE), 1.0f);
+        bins.resize((size_t)tilesX * tilesY);
+        for (std::vector<uint32_t>& bin : bins)
+            bin.reserve(256);
+        triangles.reserve(4096);
+        clip.reserve(1024);
+    }
+
+    ~OcclusionBuffer() { _mm_free(depth); }
+
+    OcclusionBuffer(const OcclusionBuffer&) = delete;
+    OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Empieza un frame con la cámara nueva (borra oclusores y estadísticas del anterior)
+    void beginFrame(const glm::mat4& newViewProjection) {
+        viewProjection = newViewProjection;
+        triangles.clear();
+        for (std::vector<uint32_t>& bin : bins)
+            bin.clear();
+        stats = FrameCounters();
+    }
+
+    void addOccluder(const OccluderMesh& mesh, const glm::mat4& model) {
+        const glm::mat4 mvp = viewProjection * model;
+        const __m128 c0 = _mm_loadu_ps(&mvp[0][0]);
+        const __m128 c1 = _mm_loadu_ps(&mvp[1][0]);
+        const __m128 c2 = _mm_loadu_ps(&mvp[2][0]);
+        const __m128 c3 = _mm_loadu_ps(&mvp[3][0]);
+        clip.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            const glm::vec3& v = mesh.vertices[i];
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(v.x)), _mm_mul_ps(c1, _mm_set1_ps(v.y))),
+                                  _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(v.z)), c3));
+            _mm_storeu_ps(&clip[i].x, r);
+        }
+
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            stats.occluderTriangles++;
+            const glm::vec4& a = clip[mesh.indices[i]];
+            const glm::vec4& b = clip[mesh.indices[i + 1]];
+            const glm::vec4& c = clip[mesh.indices[i + 2]];
+            if (a.w <= NEAR_W || b.w <= NEAR_W || c.w <= NEAR_W)
+                continue;
+            setupTriangle(toScreen(a), toScreen(b), toScreen(c));
+        }
+    }
+
+    // Llena el búfer con los triángulos anotados; un tile por tarea si hay JobSystem
+    void rasterize(JobSystem* jobs) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto rasterTiles = [this](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; tile++)
+                rasterizeTile((int)tile);
+        };
+        if (jobs)
+            jobs->parallel_for(bins.size(), 1, rasterTiles);
+        else
+            rasterTiles(0, bins.size());
+        for (const std::vector<uint32_t>& bin : bins)
+            stats.binnedTriangles += bin.size();
+        stats.rasterMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        totals.frames++;
+        totals.rasterMs += stats.rasterMs;
+    }
+
+    // Caja en coordenadas del mundo. Conservador: ante la duda (cruza el plano cercano, algún
+    // píxel más lejano que ella) se considera visible. Desde un solo hilo (lleva estadísticas).
+    bool isVisible(const glm::vec3& boxMin, const glm::vec3& boxMax) {
+        stats.tested++;
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1.0f;
+        for (int i = 0; i < 8; i++) {
+            glm::vec4 p = viewProjection * glm::vec4((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y,
+                                                     (i & 4) ? boxMax.z : boxMin.z, 1.0f);
+            if (p.w <= NEAR_W)
+                return true;
+            glm::vec3 s = toScreen(p);
+            minX = std::min(minX, s.x);
+            maxX = std::max(maxX, s.x);
+            minY = std::min(minY, s.y);
+            maxY = std::max(maxY, s.y);
+            nearest = std::min(nearest, s.z);
+        }
+        // Fuera de la pantalla lo descarta el frustum; aquí no hay nada que probar
+        if (maxX < 0.0f || maxY < 0.0f || minX >= (float)width || minY >= (float)height)
+            return true;
+        int x0 = std::max(0, (int)std::floor(minX));
+        int y0 = std::max(0, (int)std::floor(minY));
+        int x1 = std::min(width - 1, (int)std::floor(maxX));
+        int y1 = std::min(height - 1, (int)std::floor(maxY));
+
+        for (int by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++) {
+            for (int bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++) {
+                if (blockDepth[(size_t)by * blocksX + bx] <= nearest)
+                    continue; // Todo el bloque está delante de la caja
+                // Bloque con huecos o partes lejanas: revisar sólo los píxeles que cubre la caja
+                int px0 = std::max(x0, bx * BLOCK_SIZE), px1 = std::min(x1, bx * BLOCK_SIZE + BLOCK_SIZE - 1);
+                int py0 = std::max(y0, by * BLOCK_SIZE), py1 = std::min(y1, by * BLOCK_SIZE + BLOCK_SIZE - 1);
+                for (int y = py0; y <= py1; y++) {
+                    const float* row = depth + (size_t)y * width;
+                    for (int x = px0; x <= px1; x++)
+                        if (row[x] > nearest)
+                            return true;
+                }
+            }
+        }
+        stats.occluded++;
+        totals.occluded++;
+        return false;
+    }
+
+    // Profundidad de un píxel (para depurar o comparar con la GPU)
+    float depthAt(int x, int y) const { return depth[(size_t)y * width + x]; }
+
+    size_t testedLastFrame() const { return stats.tested; }
+    size_t occludedLastFrame() const { return stats.occluded; }
+
+    void report() const {
+        std::printf("Oclusion (%dx%d, %d tiles): %zu triangulos oclusores (%zu en tiles), %zu de %zu objetos ocultos | "
+                    "rasterizado prom %.3f ms, %llu objetos ocultos en %llu frames\n",
+                    width, height, tilesX * tilesY, stats.occluderTriangles, stats.binnedTriangles, stats.occluded,
+                    stats.tested, totals.frames ? totals.rasterMs / totals.frames : 0.0,
+                    (unsigned long long)totals.occluded, (unsigned long long)totals.frames);
+    }
+
+private:
+    // Triángulo listo para rasterizar: aristas E(x, y) = a*x + b*y + c (> 0 adentro) y
+    // profundidad z(x, y) = za*x + zb*y + zc, en coordenadas de píxel
+    struct ScreenTriangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float za, zb, zc;
+        int minX, minY, maxX, maxY;
+    };
+
+    struct FrameCounters {
+        size_t occluderTriangles = 0, binnedTriangles = 0, tested = 0, occluded = 0;
+        float rasterMs = 0.0f;
+    };
+
+    struct Totals {
+        uint64_t frames = 0, occluded = 0;
+        double rasterMs = 0.0;
+    };
+
+    static constexpr float NEAR_W = 1e-3f;
+
+    int width, height, tilesX, tilesY, blocksX;
+    float* depth;                          // width x height, fila 0 abajo
+    std::vector<float> blockDepth;         // Máximo (lo más lejano) de cada bloque de 8x8
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins; // Triángulos por tile
+    std::vector<glm::vec4> clip;           // Vértices del oclusor en espacio de recorte
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    FrameCounters stats;
+    Totals totals;
+
+    glm::vec3 toScreen(const glm::vec4& p) const {
+        float invW = 1.0f / p.w;
+        return glm::vec3((p.x * invW * 0.5f + 0.5f) * width, (p.y * invW * 0.5f + 0.5f) * height,
+                         p.z * invW * 0.5f + 0.5f);
+    }
+
+    void setupTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2) {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (area <= 0.0f)
+            return; // De espaldas o degenerado
+
+        ScreenTriangle t;
+        t.minX = std::max(0, (int)std::floor(std::min(v0.x, std::min(v1.x, v2.x))));
+        t.minY = std::max(0, (int)std::floor(std::min(v0.y, std::min(v1.y, v2.y))));
+        t.maxX = std::min(width - 1, (int)std::ceil(std::max(v0.x, std::max(v1.x, v2.x))));
+        t.maxY = std::min(height - 1, (int)std::ceil(std::max(v0.y, std::max(v1.y, v2.y))));
+        if (t.minX > t.maxX || t.minY > t.maxY)
+            return;
+
+        const glm::vec3* v[3] = { &v0, &v1, &v2 };
+        for (int e = 0; e < 3; e++) {
+            const glm::vec3& from = *v[e];
+            const glm::vec3& to = *v[(e + 1) % 3];
+            t.edgeA[e] = from.y - to.y;
+            t.edgeB[e] = to.x - from.x;
+            t.edgeC[e] = -(t.edgeA[e] * from.x + t.edgeB[e] * from.y);
+        }
+        float invArea = 1.0f / area;
+        t.za = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) * invArea;
+        t.zb = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) * invArea;
+        t.zc = v0.z - t.za * v0.x - t.zb * v0.y;
+
+        uint32_t index = (uint32_t)triangles.size();
+        triangles.push_back(t);
+        for (int ty = t.minY / TILE_SIZE; ty <= t.maxY / TILE_SIZE; ty++)
+            for (int tx = t.minX / TILE_SIZE; tx <= t.maxX / TILE_SIZE; tx++)
+                bins[(size_t)ty * tilesX + tx].push_back(index);
+    }
+
+    void rasterizeTile(int tile) {
+        const int tileX0 = (tile % tilesX) * TILE_SIZE, tileY0 = (tile / tilesX) * TILE_SIZE;
+        const int tileX1 = tileX0 + TILE_SIZE - 1, tileY1 = tileY0 + TILE_SIZE - 1;
+
+        const __m128 farDepth = _mm_set1_ps(1.0f);
+        for (int y = tileY0; y <= tileY1; y++)
+            for (int x = tileX0; x <= tileX1; x += 4)
+                _mm_store_ps(depth + (size_t)y * width + x, farDepth);
+
+        // Centros de los 4 píxeles de cada paso, relativos al primero
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        for (uint32_t index : bins[tile]) {
+            const ScreenTriangle& t = triangles[index];
+            int x0 = std::max(t.minX, tileX0) & ~3; // Alineado a 4 (el tile empieza alineado)
+            int x1 = std::min(t.maxX, tileX1);
+            int y0 = std::max(t.minY, tileY0), y1 = std::min(t.maxY, tileY1);
+
+            __m128 a[3];
+            for (int e = 0; e < 3; e++)
+                a[e] = _mm_set1_ps(t.edgeA[e]);
+            const __m128 za = _mm_set1_ps(t.za);
+            const __m128 step4A[3] = { _mm_set1_ps(4.0f * t.edgeA[0]), _mm_set1_ps(4.0f * t.edgeA[1]), _mm_set1_ps(4.0f * t.edgeA[2]) };
+            const __m128 step4Z = _mm_set1_ps(4.0f * t.za);
+            const __m128 xs = _mm_add_ps(_mm_set1_ps((float)x0), laneOffsets);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (int y = y0; y <= y1; y++) {
+                float py = (float)y + 0.5f;
+                __m128 edge[3];
+                for (int e = 0; e < 3; e++)
+                    edge[e] = _mm_add_ps(_mm_mul_ps(a[e], xs), _mm_set1_ps(t.edgeB[e] * py + t.edgeC[e]));
+                __m128 z = _mm_add_ps(_mm_mul_ps(za, xs), _mm_set1_ps(t.zb * py + t.zc));
+                float* row = depth + (size_t)y * width;
+                for (int x = x0; x <= x1; x += 4) {
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(edge[0], zero), _mm_cmpgt_ps(edge[1], zero)),
+                                               _mm_cmpgt_ps(edge[2], zero));
+                    if (_mm_movemask_ps(inside)) {
+                        __m128 d = _mm_load_ps(row + x);
+                        __m128 nearer = _mm_min_ps(d, z);
+                        _mm_store_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, d)));
+                    }
+                    for (int e = 0; e < 3; e++)
+                        edge[e] = _mm_add_ps(edge[e], step4A[e]);
+                    z = _mm_add_ps(z, step4Z);
+                }
+            }
+        }
+
+        // Nivel jerárquico de los bloques de este tile
+        for (int by = tileY0 / BLOCK_SIZE; by <= tileY1 / BLOCK_SIZE; by++) {
+            for (int bx = tileX0 / BLOCK_SIZE; bx <= tileX1 / BLOCK_SIZE; bx++) {
+                __m128 farthest = _mm_setzero_ps();
+                for (int y = by * BLOCK_SIZE; y < (by + 1) * BLOCK_SIZE; y++) {
+                    const float* row = depth + (size_t)y * width + bx * BLOCK_SIZE;
+                    farthest = _mm_max_ps(farthest, _mm_max_ps(_mm_load_ps(row), _mm_load_ps(row + 4)));
+                }
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, farthest);
+                blockDepth[(size_t)by * blocksX + bx] = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+            }
+        }
+    }
+};
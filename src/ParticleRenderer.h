@@ -0,0 +1,72 @@
+#pragma once
+
+// Dibuja las partículas como billboards: un solo quad instanciado una vez por partícula.
+// Los datos por instancia se copian al StreamBuffer del frame, así no hay búfer propio
+// que redimensionar ni sincronizar.
+
+#include <glad/glad.h>
+
+#include "GpuResources.h"
+#include "ParticleSystem.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include "UniformBlocks.h"
+
+#include <cstddef>
+#include <cstring>
+
+class ParticleRenderer {
+public:
+    // Hilo con el contexto
+    void init() {
+        shader = Shader("src/particle.vert", "src/particle.frag");
+        shader.bindUniformBlock("FrameData", UBO_FRAME);
+
+        // Esquinas del quad en [-1, 1] (triangle strip)
+        float corners[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+        VAO = GpuVertexArray::generate();
+        quadVBO = GpuBuffer::generate();
+        glBindVertexArray(VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO.id());
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+        // Atributos por instancia; el puntero real se pone en cada draw (cambia el offset)
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+        glBindVertexArray(0);
+    }
+
+    // Después de lo opaco: mezcla aditiva y sin escribir profundidad
+    void draw(const ParticleInstance* instances, size_t count, StreamBuffer& stream) {
+        if (count == 0)
+            return;
+        StreamAllocation a = stream.allocateVertices(count * sizeof(ParticleInstance));
+        if (!a)
+            return;
+        std::memcpy(a.data, instances, count * sizeof(ParticleInstance));
+        stream.commit();
+
+        shader.use();
+        glBindVertexArray(VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, stream.id());
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(a.offset));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance),
+                              (void*)(a.offset + offsetof(ParticleInstance, color)));
+
+        glDepthMask(GL_FALSE);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_TRUE);
+        glBindVertexArray(0);
+    }
+
+private:
+    Shader shader;
+    GpuVertexArray VAO;
+    GpuBuffer quadVBO;
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+// Partículas para los ataques de energía.
+//
+// Los datos están en estructura de arreglos (un arreglo por componente, alineados a 32
+// bytes) para que la integración avance 8 (AVX2) o 4 (SSE) partículas por instrucción.
+// Las partículas muertas se compactan trayendo la última al hueco, así los arreglos nunca
+// cambian de tamaño: la capacidad se fija al construir.
+//
+// La simulación corre en el hilo principal (en bloques repartidos con el JobSystem) y
+// writeInstances() deja el resultado listo para dibujarse como billboards instanciados.
+// Si un update se pasa del presupuesto de CPU, la emisión baja hasta que vuelva a caber.
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+// Lo que lee el shader de partículas por instancia (ver particle.vert)
+struct ParticleInstance {
+    glm::vec4 positionSize; // xyz = centro, w = tamaño
+    glm::vec4 color;        // rgb = color, a = vida restante (1 -> 0)
+};
+
+enum ParticleEmitterType {
+    EMITTER_TRAIL, // Estela continua detrás de algo que se mueve
+    EMITTER_BURST, // Explosión de una sola vez (ver ParticleSystem::burst)
+    EMITTER_AURA   // Anillo alrededor de un punto que sube
+};
+
+struct ParticleEmitter {
+    ParticleEmitterType type = EMITTER_TRAIL;
+    bool active = false;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float rate = 1000.0f;     // Partículas por segundo (TRAIL / AURA)
+    float speed = 1.0f;       // Velocidad inicial
+    float lifetime = 1.0f;    // Segundos
+    float size = 0.1f;
+    float radius = 0.5f;      // Radio del anillo (AURA)
+    float lift = 0.0f;        // Aceleración vertical (negativa = gravedad)
+
+    // Estado interno
+    glm::vec3 lastPosition = glm::vec3(0.0f);
+    float accumulator = 0.0f;
+    bool hasLastPosition = false;
+};
+
+class ParticleSystem {
+public:
+    float budgetMs = 1.0f; // Presupuesto de CPU para update()
+    float drag = 0.8f;     // Frenado del aire (1/s)
+
+    explicit ParticleSystem(size_t capacity) {
+        // Múltiplo de 8 para que el último bloque SIMD no se salga
+        maxParticles = (capacity + 7) & ~(size_t)7;
+        storage = static_cast<float*>(_mm_malloc(maxParticles * STREAM_COUNT * sizeof(float), 32));
+        for (int s = 0; s < STREAM_COUNT; s++)
+            streams[s] = storage + s * maxParticles;
+        emitters.reserve(16);
+    }
+
+    ~ParticleSystem() { _mm_free(storage); }
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    size_t capacity() const { return maxParticles; }
+    size_t size() const { return count; }
+
+    int addEmitter(const ParticleEmitter& emitter) {
+        emitters.push_back(emitter);
+        return (int)emitters.size() - 1;
+    }
+
+    ParticleEmitter& emitter(int index) { return emitters[index]; }
+
+    // Emite 'amount' partículas en todas direcciones desde la posición del emisor
+    void burst(const ParticleEmitter& e, unsigned int amount) {
+        amount = (unsigned int)(amount * emissionScale);
+        for (unsigned int i = 0; i < amount; i++)
+            spawn(e.position, randomDirection() * (e.speed * (0.5f + 0.5f * random())), e);
+    }
+
+    // Estela entre dos puntos con la configuración de 'e' (para cosas que no tienen emisor
+    // propio, ej. cada proyectil). Repartidas sobre el tramo: la estela no se corta.
+    void emitSegment(const ParticleEmitter& e, const glm::vec3& from, const glm::vec3& to, unsigned int amount) {
+        for (unsigned int i = 0; i < amount; i++) {
+            glm::vec3 position = glm::mix(from, to, (i + random()) / amount);
+            spawn(position, randomDirection() * (e.speed * random()), e);
+        }
+    }
+
+    // 1 = emisión completa; baja cuando update() se pasa del presupuesto
+    float emissionScaleFactor() const { return emissionScale; }
+
+    void update(float dt, JobSystem* jobs) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (ParticleEmitter& e : emitters)
+            emit(e, dt);
+
+        // Integración en bloques de 8192 (múltiplo de 8: cada bloque empieza alineado)
+        float dragFactor = 1.0f / (1.0f + drag * dt);
+        if (jobs)
+            jobs->parallel_for(count, 8192, [this, dt, dragFactor](size_t begin, size_t end) {
+                integrate(begin, end, dt, dragFactor);
+            });
+        else
+            integrate(0, count, dt, dragFactor);
+
+        compact();
+
+        // Control del presupuesto: si nos pasamos, se emite menos hasta recuperarnos
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        if (ms > budgetMs)
+            emissionScale = emissionScale * 0.9f > 0.1f ? emissionScale * 0.9f : 0.1f;
+        else if (ms < budgetMs * 0.8f)
+            emissionScale = emissionScale * 1.05f < 1.0f ? emissionScale * 1.05f : 1.0f;
+
+        totalMs += ms;
+        if (ms > worstMs) worstMs = ms;
+        if (count > peakCount) peakCount = count;
+        if (emissionScale < lowestScale) lowestScale = emissionScale;
+        updates++;
+    }
+
+    // Pasa las partículas vivas al formato de instancias (sin asignar memoria después de
+    // la primera vez: el vector se reserva a la capacidad total)
+    void writeInstances(std::vector<ParticleInstance>& out) const {
+        if (out.capacity() < maxParticles)
+            out.reserve(maxParticles);
+        out.resize(count);
+        const float* px = streams[PX]; const float* py = streams[PY]; const float* pz = streams[PZ];
+        const float* life = streams[LIFE]; const float* invLifetime = streams[INV_LIFETIME];
+        const float* size = streams[SIZE];
+        const float* cr = streams[CR]; const float* cg = streams[CG]; const float* cb = streams[CB];
+        for (size_t i = 0; i < count; i++) {
+            out[i].positionSize = glm::vec4(px[i], py[i], pz[i], size[i]);
+            out[i].color = glm::vec4(cr[i], cg[i], cb[i], life[i] * invLifetime[i]);
+        }
+    }
+
+    void clear() { count = 0; }
+
+    void report() const {
+        std::printf("Particulas: pico %zu de %zu, update prom %.3f ms (peor %.3f, presupuesto %.2f), "
+                    "emision minima %.0f%%, %llu descartadas por capacidad\n",
+                    peakCount, maxParticles, updates ? totalMs / updates : 0.0, worstMs, budgetMs,
+                    lowestScale * 100.0f, (unsigned long long)dropped);
+    }
+
+private:
+    enum Stream { PX, PY, PZ, VX, VY, VZ, AY, LIFE, INV_LIFETIME, SIZE, CR, CG, CB, STREAM_COUNT };
+
+    float* storage = nullptr;
+    float* streams[STREAM_COUNT];
+    size_t maxParticles = 0;
+    size_t count = 0;
+
+    std::vector<ParticleEmitter> emitters;
+    float emissionScale = 1.0f;
+    uint32_t rngState = 0x9E3779B9u;
+
+    // Estadísticas
+    size_t peakCount = 0;
+    uint64_t updates = 0, dropped = 0;
+    double totalMs = 0.0;
+    float worstMs = 0.0f, lowestScale = 1.0f;
+
+    float random() {
+        // xorshift32 -> [0, 1)
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return (rngState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    glm::vec3 randomDirection() {
+        glm::vec3 d;
+        float lengthSq;
+        do {
+            d = glm::vec3(random(), random(), random()) * 2.0f - 1.0f;
+            lengthSq = glm::dot(d, d);
+        } while (lengthSq > 1.0f || lengthSq < 1e-4f);
+        return d / std::sqrt(lengthSq);
+    }
+
+    void spawn(const glm::vec3& position, const glm::vec3& velocity, const ParticleEmitter& e) {
+        if (count >= maxParticles) {
+            dropped++;
+            return;
+        }
+        size_t i = count++;
+        streams[PX][i] = position.x; streams[PY][i] = position.y; streams[PZ][i] = position.z;
+        streams[VX][i] = velocity.x; streams[VY][i] = velocity.y; streams[VZ][i] = velocity.z;
+        streams[AY][i] = e.lift;
+        float lifetime = e.lifetime * (0.75f + 0.5f * random());
+        streams[LIFE][i] = lifetime;
+        streams[INV_LIFETIME][i] = 1.0f / lifetime;
+        streams[SIZE][i] = e.size * (0.75f + 0.5f * random());
+        streams[CR][i] = e.color.r; streams[CG][i] = e.color.g; streams[CB][i] = e.color.b;
+    }
+
+    void emit(ParticleEmitter& e, float dt) {
+        if (!e.active || e.type == EMITTER_BURST) {
+            e.hasLastPosition = false;
+            e.accumulator = 0.0f;
+            return;
+        }
+        e.accumulator += e.rate * emissionScale * dt;
+        unsigned int amount = (unsigned int)e.accumulator;
+        e.accumulator -= (float)amount;
+
+        if (e.type == EMITTER_TRAIL) {
+            emitSegment(e, e.hasLastPosition ? e.lastPosition : e.position, e.position, amount);
+        } else {
+            for (unsigned int i = 0; i < amount; i++) {
+                float angle = random() * 6.2831853f;
+                glm::vec3 offset(std::cos(angle) * e.radius, random() * 0.3f, std::sin(angle) * e.radius);
+                glm::vec3 velocity = glm::vec3(offset.x, 0.0f, offset.z) * 0.2f + glm::vec3(0.0f, e.speed, 0.0f);
+                spawn(e.position + offset, velocity, e);
+            }
+        }
+        e.lastPosition = e.position;
+        e.hasLastPosition = true;
+    }
+
+    // v += a*dt; v *= drag; p += v*dt; vida -= dt
+    void integrate(size_t begin, size_t end, float dt, float dragFactor) {
+        float* px = streams[PX]; float* py = streams[PY]; float* pz = streams[PZ];
+        float* vx = streams[VX]; float* vy = streams[VY]; float* vz = streams[VZ];
+        const float* ay = streams[AY];
+        float* life = streams[LIFE];
+        size_t i = begin;
+
+#if defined(__AVX2__)
+        const __m256 dt8 = _mm256_set1_ps(dt);
+        const __m256 drag8 = _mm256_set1_ps(dragFactor);
+        for (; i + 8 <= end; i += 8) {
+            __m256 x = _mm256_mul_ps(_mm256_load_ps(vx + i), drag8);
+            __m256 y = _mm256_mul_ps(_mm256_add_ps(_mm256_load_ps(vy + i), _mm256_mul_ps(_mm256_load_ps(ay + i), dt8)), drag8);
+            __m256 z = _mm256_mul_ps(_mm256_load_ps(vz + i), drag8);
+            _mm256_store_ps(vx + i, x);
+            _mm256_store_ps(vy + i, y);
+            _mm256_store_ps(vz + i, z);
+            _mm256_store_ps(px + i, _mm256_add_ps(_mm256_load_ps(px + i), _mm256_mul_ps(x, dt8)));
+            _mm256_store_ps(py + i, _mm256_add_ps(_mm256_load_ps(py + i), _mm256_mul_ps(y, dt8)));
+            _mm256_store_ps(pz + i, _mm256_add_ps(_mm256_load_ps(pz + i), _mm256_mul_ps(z, dt8)));
+            _mm256_store_ps(life + i, _mm256_sub_ps(_mm256_load_ps(life + i), dt8));
+        }
+#endif
+        const __m128 dt4 = _mm_set1_ps(dt);
+        const __m128 drag4 = _mm_set1_ps(dragFactor);
+        for (; i + 4 <= end; i += 4) {
+            __m128 x = _mm_mul_ps(_mm_load_ps(vx + i), drag4);
+            __m128 y = _mm_mul_ps(_mm_add_ps(_mm_load_ps(vy + i), _mm_mul_ps(_mm_load_ps(ay + i), dt4)), drag4);
+            __m128 z = _mm_mul_ps(_mm_load_ps(vz + i), drag4);
+            _mm_store_ps(vx + i, x);
+            _mm_store_ps(vy + i, y);
+            _mm_store_ps(vz + i, z);
+            _mm_store_ps(px + i, _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(x, dt4)));
+            _mm_store_ps(py + i, _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(y, dt4)));
+            _mm_store_ps(pz + i, _mm_add_ps(_mm_load_ps(pz + i), _mm_mul_ps(z, dt4)));
+            _mm_store_ps(life + i, _mm_sub_ps(_mm_load_ps(life + i), dt4));
+        }
+        for (; i < end; i++) {
+            vx[i] *= dragFactor;
+            vy[i] = (vy[i] + ay[i] * dt) * dragFactor;
+            vz[i] *= dragFactor;
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pz[i] += vz[i] * dt;
+            life[i] -= dt;
+        }
+    }
+
+    // Quita las muertas moviendo la última partícula a su lugar (el orden no importa)
+    void compact() {
+        float* life = streams[LIFE];
+        size_t i = 0;
+        while (i < count) {
+            if (life[i] > 0.0f) {
+                i++;
+                continue;
+            }
+            count--;
+            for (int s = 0; s < STREAM_COUNT; s++)
+                streams[s][i] = streams[s][count];
+        }
+    }
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+// Proyectiles de energía que siguen una curva de Bézier cúbica.
+//
+// Capacidad fija y estructura de arreglos: los puntos de control, la posición y el avance
+// de cada proyectil viven en arreglos separados y alineados, así calculateBezierBatch
+// evalúa todos los proyectiles vivos en una sola llamada. Al terminar su curva el proyectil
+// se quita trayendo el último a su lugar y su punto final queda en impacts().
+//
+// Avanzar 't' a ritmo constante no da velocidad constante (la curva se estira donde los
+// puntos de control están lejos). Por eso cada proyectil guarda una tabla de longitud de
+// arco: para ARC_SAMPLES + 1 distancias uniformes a lo largo de la curva, el 't' que le
+// corresponde. El proyectil avanza en distancia y la tabla la convierte a 't'.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Bezier.h"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <xmmintrin.h>
+
+class ProjectilePool {
+public:
+    static constexpr int ARC_SAMPLES = 16;
+
+    explicit ProjectilePool(size_t capacity) {
+        maxProjectiles = (capacity + 3) & ~(size_t)3;
+        storage = static_cast<float*>(_mm_malloc(maxProjectiles * STREAM_COUNT * sizeof(float), 16));
+        for (int s = 0; s < STREAM_COUNT; s++)
+            streams[s] = storage + s * maxProjectiles;
+        finished.reserve(maxProjectiles);
+    }
+
+    ~ProjectilePool() { _mm_free(storage); }
+
+    ProjectilePool(const ProjectilePool&) = delete;
+    ProjectilePool& operator=(const ProjectilePool&) = delete;
+
+    size_t capacity() const { return maxProjectiles; }
+    size_t size() const { return count; }
+
+    // Lanza un proyectil que recorre la curva completa en 'duration' segundos a velocidad
+    // constante. Devuelve false si el pool está lleno.
+    bool spawn(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float duration) {
+        if (count >= maxProjectiles)
+            return false;
+        size_t i = count++;
+        const glm::vec3 points[4] = { p0, p1, p2, p3 };
+        for (int p = 0; p < 4; p++) {
+            streams[P0X + p * 3][i] = points[p].x;
+            streams[P0Y + p * 3][i] = points[p].y;
+            streams[P0Z + p * 3][i] = points[p].z;
+        }
+        float length = buildArcTable(i, p0, p1, p2, p3);
+        streams[DISTANCE][i] = 0.0f;
+        streams[SPEED][i] = length / duration;
+        streams[INV_LENGTH][i] = length > 0.0f ? 1.0f / length : 0.0f;
+        streams[T][i] = 0.0f;
+        streams[X][i] = streams[PREV_X][i] = p0.x;
+        streams[Y][i] = streams[PREV_Y][i] = p0.y;
+        streams[Z][i] = streams[PREV_Z][i] = p0.z;
+        return true;
+    }
+
+    void update(float dt) {
+        finished.clear();
+        if (count == 0)
+            return;
+
+        std::memcpy(streams[PREV_X], streams[X], count * sizeof(float));
+        std::memcpy(streams[PREV_Y], streams[Y], count * sizeof(float));
+        std::memcpy(streams[PREV_Z], streams[Z], count * sizeof(float));
+
+        // Distancia recorrida -> fracción de la longitud -> 't' por la tabla de arco
+        float* distance = streams[DISTANCE];
+        const float* speed = streams[SPEED];
+        const float* invLength = streams[INV_LENGTH];
+        float* t = streams[T];
+        for (size_t i = 0; i < count; i++) {
+            distance[i] += speed[i] * dt;
+            float u = distance[i] * invLength[i];
+            if (u >= 1.0f || invLength[i] == 0.0f) {
+                t[i] = 1.0f;
+                continue;
+            }
+            float scaled = u * ARC_SAMPLES;
+            int k = (int)scaled;
+            float a = streams[ARC_TABLE + k][i];
+            float b = streams[ARC_TABLE + k + 1][i];
+            t[i] = a + (b - a) * (scaled - (float)k);
+        }
+
+        BezierCurvesSoA curves = {
+            streams[P0X], streams[P0Y], streams[P0Z], streams[P1X], streams[P1Y], streams[P1Z],
+            streams[P2X], streams[P2Y], streams[P2Z], streams[P3X], streams[P3Y], streams[P3Z]
+        };
+        calculateBezierBatch(curves, t, streams[X], streams[Y], streams[Z], count);
+
+        // Los que llegaron al final se reportan como impacto y se quitan
+        size_t i = 0;
+        while (i < count) {
+            if (t[i] < 1.0f) {
+                i++;
+                continue;
+            }
+            finished.push_back(position(i));
+            count--;
+            for (int s = 0; s < STREAM_COUNT; s++)
+                streams[s][i] = streams[s][count];
+        }
+    }
+
+    glm::vec3 position(size_t i) const { return glm::vec3(streams[X][i], streams[Y][i], streams[Z][i]); }
+    glm::vec3 previousPosition(size_t i) const { return glm::vec3(streams[PREV_X][i], streams[PREV_Y][i], streams[PREV_Z][i]); }
+
+    // Puntos donde terminaron su curva los proyectiles en el último update()
+    const std::vector<glm::vec3>& impacts() const { return finished; }
+
+    // Matrices model para dibujar todos los proyectiles instanciados
+    void writeModels(std::vector<glm::mat4>& out, float scale) const {
+        if (out.capacity() < maxProjectiles)
+            out.reserve(maxProjectiles);
+        out.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            glm::mat4 m(scale);
+            m[3] = glm::vec4(streams[X][i], streams[Y][i], streams[Z][i], 1.0f);
+            out[i] = m;
+        }
+    }
+
+    void clear() { count = 0; }
+
+private:
+    enum Stream {
+        P0X, P0Y, P0Z, P1X, P1Y, P1Z, P2X, P2Y, P2Z, P3X, P3Y, P3Z,
+        X, Y, Z, PREV_X, PREV_Y, PREV_Z,
+        DISTANCE, SPEED, INV_LENGTH, T,
+        ARC_TABLE, // ARC_SAMPLES + 1 arreglos: 't' para la distancia k / ARC_SAMPLES
+        STREAM_COUNT = ARC_TABLE + ARC_SAMPLES + 1
+    };
+
+    float* storage = nullptr;
+    float* streams[STREAM_COUNT];
+    size_t maxProjectiles = 0;
+    size_t count = 0;
+    std::vector<glm::vec3> finished;
+
+    // Llena la tabla de arco del proyectil i y devuelve la longitud de la curva
+    float buildArcTable(size_t i, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) {
+        // Longitud acumulada en ARC_SAMPLES tramos de 't' uniforme
+        float lengths[ARC_SAMPLES + 1];
+        lengths[0] = 0.0f;
+        glm::vec3 previous = p0;
+        for (int j = 1; j <= ARC_SAMPLES; j++) {
+            glm::vec3 point = calculateBezier((float)j / ARC_SAMPLES, p0, p1, p2, p3);
+            lengths[j] = lengths[j - 1] + glm::length(point - previous);
+            previous = point;
+        }
+        float total = lengths[ARC_SAMPLES];
+
+        // Invertimos: para cada distancia uniforme buscamos el tramo y su 't'
+        int j = 0;
+        for (int k = 0; k <= ARC_SAMPLES; k++) {
+            float target = total * (float)k / ARC_SAMPLES;
+            while (j < ARC_SAMPLES - 1 && lengths[j + 1] < target)
+                j++;
+            float segment = lengths[j + 1] - lengths[j];
+            float f = segment > 0.0f ? (target - lengths[j]) / segment : 0.0f;
+            f = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+            streams[ARC_TABLE + k][i] = ((float)j + f) / ARC_SAMPLES;
+        }
+        return total;
+    }
+};
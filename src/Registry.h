@@ -0,0 +1,262 @@
+#pragma once
+
+// Entidades y componentes (ECS de conjuntos dispersos).
+//
+// Una entidad es sólo un índice + generación (como GpuHandle): al destruirla la generación
+// sube y las copias viejas dejan de ser válidas. Cada tipo de componente vive en su propio
+// pool con dos arreglos:
+//   - denso: los componentes contiguos, más la entidad dueña de cada uno
+//   - disperso: por índice de entidad, la posición de su componente en el denso
+// Así recorrer un tipo de componente es lineal en memoria, y agregar, quitar o buscar el
+// componente de una entidad es O(1). Quitar trae el último al hueco (el orden no se guarda).
+//
+//   Entity goku = registry.create();
+//   registry.add<Transform>(goku, Transform{ ... });
+//   registry.each<Player, Transform>([](Entity e, Player& p, Transform& t) { ... });
+//
+// Las consultas recorren el pool del PRIMER tipo y buscan los demás por entidad: conviene
+// poner primero el componente menos común. parallelEach reparte ese recorrido entre los
+// workers; la función sólo puede tocar los componentes de su entidad. Crear/destruir
+// entidades o agregar/quitar componentes durante una consulta no está permitido.
+//
+// No es thread-safe: la estructura se modifica sólo desde el hilo de la simulación.
+
+#include "JobSystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct Entity {
+    uint32_t index = 0;      // 0 = nula; las entidades válidas empiezan en 1
+    uint32_t generation = 0;
+
+    bool valid() const { return index != 0; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+class ComponentPoolBase {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    virtual ~ComponentPoolBase() = default;
+    virtual void remove(Entity e) = 0;
+    virtual size_t bytes() const = 0;
+
+    bool has(Entity e) const { return e.index < sparse.size() && sparse[e.index] != NONE; }
+    size_t size() const { return entities.size(); }
+    const Entity* data() const { return entities.data(); }
+
+protected:
+    std::vector<Entity> entities;   // Dueño de cada componente del arreglo denso
+    std::vector<uint32_t> sparse;   // Índice de entidad -> posición en el denso (o NONE)
+};
+
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    void reserve(size_t count) {
+        components.reserve(count);
+        entities.reserve(count);
+    }
+
+    T& add(Entity e, T value) {
+        if (e.index >= sparse.size())
+            sparse.resize(e.index + 1, NONE);
+        if (sparse[e.index] != NONE) {
+            T& existing = components[sparse[e.index]];
+            existing = std::move(value);
+            return existing;
+        }
+        sparse[e.index] = (uint32_t)components.size();
+        components.push_back(std::move(value));
+        entities.push_back(e);
+        return components.back();
+    }
+
+    void remove(Entity e) override {
+        if (!has(e))
+            return;
+        uint32_t slot = sparse[e.index];
+        uint32_t last = (uint32_t)components.size() - 1;
+        if (slot != last) {
+            components[slot] = std::move(components[last]);
+            entities[slot] = entities[last];
+            sparse[entities[slot].index] = slot;
+        }
+        components.pop_back();
+        entities.pop_back();
+        sparse[e.index] = NONE;
+    }
+
+    // La entidad tiene que tener el componente (ver has/tryGet)
+    T& get(Entity e) { return components[sparse[e.index]]; }
+    const T& get(Entity e) const { return components[sparse[e.index]]; }
+    T* tryGet(Entity e) { return has(e) ? &components[sparse[e.index]] : nullptr; }
+
+    T& at(size_t slot) { return components[slot]; }
+    Entity entityAt(size_t slot) const { return entities[slot]; }
+
+    size_t bytes() const override {
+        return components.capacity() * sizeof(T) + entities.capacity() * sizeof(Entity) + sparse.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    std::vector<T> components;
+};
+
+class Registry {
+public:
+    Registry() {
+        generations.push_back(0); // El índice 0 queda reservado como entidad nula
+    }
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    // Reserva lugar para 'count' entidades; los pools se reservan con pool<T>().reserve()
+    void reserve(size_t count) {
+        generations.reserve(count + 1);
+        freeIndices.reserve(count);
+    }
+
+    Entity create() {
+        uint32_t index;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        } else {
+            index = (uint32_t)generations.size();
+            generations.push_back(1);
+        }
+        alive++;
+        return { index, generations[index] };
+    }
+
+    // Quita todos los componentes de la entidad y recicla su índice
+    void destroy(Entity e) {
+        if (!isAlive(e))
+            return;
+        for (auto& pool : pools)
+            if (pool)
+                pool->remove(e);
+        generations[e.index]++;
+        freeIndices.push_back(e.index);
+        alive--;
+    }
+
+    bool isAlive(Entity e) const {
+        return e.valid() && e.index < generations.size() && generations[e.index] == e.generation;
+    }
+
+    template <typename T>
+    T& add(Entity e, T value = T()) { return pool<T>().add(e, std::move(value)); }
+
+    template <typename T>
+    void remove(Entity e) { pool<T>().remove(e); }
+
+    template <typename T>
+    bool has(Entity e) const {
+        const ComponentPoolBase* p = findPool(typeId<T>());
+        return p && p->has(e);
+    }
+
+    template <typename T>
+    T& get(Entity e) { return pool<T>().get(e); }
+
+    template <typename T>
+    T* tryGet(Entity e) { return isAlive(e) ? pool<T>().tryGet(e) : nullptr; }
+
+    template <typename T>
+    ComponentPool<T>& pool() {
+        uint32_t id = typeId<T>();
+        if (id >= pools.size())
+            pools.resize(id + 1);
+        if (!pools[id])
+            pools[id].reset(new ComponentPool<T>());
+        return static_cast<ComponentPool<T>&>(*pools[id]);
+    }
+
+    // Llama fn(entidad, A&, B&...) para cada entidad que tiene todos los componentes
+    template <typename A, typename... Rest, typename F>
+    void each(F&& fn) {
+        eachRange<A, Rest...>(0, pool<A>().size(), fn);
+    }
+
+    // Como each, pero repartiendo el pool de A en bloques de 'grain' entre los workers
+    template <typename A, typename... Rest, typename F>
+    void parallelEach(JobSystem* jobs, size_t grain, const F& fn) {
+        size_t count = pool<A>().size();
+        // Los pools de Rest se crean aquí, antes de que los workers los busquen
+        int touch[] = { 0, ((void)pool<Rest>(), 0)... };
+        (void)touch;
+        if (!jobs) {
+            eachRange<A, Rest...>(0, count, fn);
+            return;
+        }
+        jobs->parallel_for(count, grain, [&](size_t begin, size_t end) { eachRange<A, Rest...>(begin, end, fn); });
+    }
+
+    size_t size() const { return alive; }
+
+    void report() const {
+        size_t bytes = generations.capacity() * sizeof(uint32_t) + freeIndices.capacity() * sizeof(uint32_t);
+        size_t poolCount = 0;
+        for (const auto& pool : pools) {
+            if (!pool)
+                continue;
+            bytes += pool->bytes();
+            poolCount++;
+        }
+        std::printf("Entidades: %zu vivas, %zu tipos de componente, %.1f KB\n", alive, poolCount, bytes / 1024.0);
+    }
+
+private:
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeIndices;
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools;
+    size_t alive = 0;
+
+    // Un id secuencial por tipo de componente, asignado la primera vez que se usa
+    static uint32_t nextTypeId() {
+        static uint32_t counter = 0;
+        return counter++;
+    }
+
+    template <typename T>
+    static uint32_t typeId() {
+        static const uint32_t id = nextTypeId();
+        return id;
+    }
+
+    const ComponentPoolBase* findPool(uint32_t id) const {
+        return id < pools.size() ? pools[id].get() : nullptr;
+    }
+
+    // Los pools se buscan una vez por bloque, no por entidad
+    template <typename A, typename... Rest, typename F>
+    void eachRange(size_t begin, size_t end, F& fn) {
+        eachSlots(begin, end, fn, pool<A>(), pool<Rest>()...);
+    }
+
+    template <typename A, typename F, typename... Others>
+    static void eachSlots(size_t begin, size_t end, F& fn, ComponentPool<A>& driver, Others&... others) {
+        for (size_t i = begin; i < end; i++) {
+            Entity e = driver.entityAt(i);
+            if (!allHave(e, others...))
+                continue;
+            fn(e, driver.at(i), others.get(e)...);
+        }
+    }
+
+    static bool allHave(Entity) { return true; }
+
+    template <typename Pool, typename... Others>
+    static bool allHave(Entity e, const Pool& first, const Others&... others) {
+        return first.has(e) && allHave(e, others...);
+    }
+};
@@ -0,0 +1,410 @@
+#pragma once
+
+// Grafo de render: los pases declaran qué texturas leen y escriben, y el grafo decide el
+// resto.
+//
+// Se arma una vez (addPass con una función de setup y otra de ejecución) y compile() lo
+// prepara para un tamaño de pantalla:
+//   1. Quita los pases cuyo resultado nadie usa (ni otro pase, ni una textura importada
+//      como el backbuffer, ni un efecto lateral declarado).
+//   2. Calcula la vida de cada textura transitoria: del primer al último pase vivo que la toca.
+//   3. Reparte las transitorias en texturas físicas: dos con el mismo tamaño y formato cuyas
+//      vidas no se cruzan comparten la misma textura de OpenGL.
+//   4. Anota las transiciones de cada textura (destino de render <-> lectura en shader). En
+//      OpenGL 3.3 no hay barreras explícitas: cambiar de framebuffer entre pases basta, pero
+//      la lista queda en el volcado para revisar el orden.
+//   5. Crea un framebuffer por pase con sus salidas.
+// execute() sólo enlaza el framebuffer de cada pase vivo y llama a su función. Recompilar
+// sólo hace falta si cambia el tamaño.
+
+#include <glad/glad.h>
+
+#include "GpuResources.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include <iostream>
+
+enum RenderGraphFormat : uint32_t {
+    RG_FORMAT_RGBA8,
+    RG_FORMAT_RGBA16F,
+    RG_FORMAT_DEPTH24,
+    RG_FORMAT_R11G11B10F,  // HDR sin alfa en 4 bytes (bloom)
+    RG_FORMAT_COUNT
+};
+
+// Tamaño relativo a la pantalla (scale) o fijo (width/height > 0, ej. un shadow map)
+struct RenderGraphTextureDesc {
+    RenderGraphFormat format = RG_FORMAT_RGBA8;
+    float scale = 1.0f;
+    int width = 0, height = 0;
+};
+
+typedef uint32_t RenderGraphHandle;
+static const RenderGraphHandle RG_INVALID_HANDLE = 0xFFFFFFFFu;
+
+enum RenderGraphState : uint8_t {
+    RG_STATE_UNDEFINED,   // Recién asignada (o heredada de otra textura con la que comparte memoria)
+    RG_STATE_ATTACHMENT,  // Destino de render
+    RG_STATE_SHADER_READ  // Se muestrea en un shader
+};
+
+class RenderGraph;
+
+// Lo que recibe la función de ejecución de un pase
+struct RenderGraphContext {
+    const RenderGraph* graph;
+    int width, height;         // Tamaño de pantalla con el que se compiló
+    GLuint texture(RenderGraphHandle handle) const;
+    int textureWidth(RenderGraphHandle handle) const;
+    int textureHeight(RenderGraphHandle handle) const;
+};
+
+class RenderGraph {
+public:
+    typedef std::function<void(const RenderGraphContext&)> ExecuteFunction;
+
+    // Declaraciones de un pase (sólo dentro de su función de setup)
+    class Builder {
+    public:
+        RenderGraphHandle create(const char* name, const RenderGraphTextureDesc& desc) {
+            return graph.addResource(name, desc, false, 0);
+        }
+        void read(RenderGraphHandle handle) { graph.passes[pass].reads.push_back(handle); }
+        void write(RenderGraphHandle handle) { graph.passes[pass].writes.push_back(handle); }
+        // El pase hace algo fuera del grafo (ej. lecturas a la CPU): nunca se quita
+        void sideEffect() { graph.passes[pass].sideEffect = true; }
+
+    private:
+        friend class RenderGraph;
+        Builder(RenderGraph& graph, uint32_t pass) : graph(graph), pass(pass) {}
+        RenderGraph& graph;
+        uint32_t pass;
+    };
+
+    // Textura que vive fuera del grafo (0 = backbuffer). Escribir en ella mantiene vivo al pase.
+    RenderGraphHandle importTexture(const char* name, GLuint texture, const RenderGraphTextureDesc& desc = RenderGraphTextureDesc()) {
+        return addResource(name, desc, true, texture);
+    }
+
+    template <typename Setup>
+    void addPass(const char* name, const Setup& setup, ExecuteFunction execute) {
+        passes.push_back(Pass());
+        passes.back().name = name;
+        passes.back().execute = std::move(execute);
+        Builder builder(*this, (uint32_t)passes.size() - 1);
+        setup(builder);
+        compiledWidth = 0; // El grafo cambió
+    }
+
+    bool needsCompile(int width, int height) const { return width != compiledWidth || height != compiledHeight; }
+
+    // Hilo con el contexto
+    void compile(int width, int height) {
+        compiledWidth = width;
+        compiledHeight = height;
+        cullPasses();
+        computeLifetimes();
+        assignPhysicalTextures();
+        computeBarriers();
+        createFramebuffers();
+        compileCount++;
+    }
+
+    void execute() const {
+        RenderGraphContext context = { this, compiledWidth, compiledHeight };
+        for (const Pass& pass : passes) {
+            if (pass.culled)
+                continue;
+            glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer.id());
+            pass.execute(context);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    GLuint texture(RenderGraphHandle handle) const {
+        const Resource& r = resources[handle];
+        if (r.imported)
+            return r.importedTexture;
+        return r.physical < physicals.size() ? physicals[r.physical].texture.id() : 0;
+    }
+    int textureWidth(RenderGraphHandle handle) const { return resolveWidth(resources[handle].desc); }
+    int textureHeight(RenderGraphHandle handle) const { return resolveHeight(resources[handle].desc); }
+
+    size_t transientBytes() const { return virtualBytes; }
+    size_t allocatedBytes() const { return physicalBytes; }
+
+    // Volcado del grafo compilado: pases (con los quitados), vidas, alias y transiciones
+    void dump() const {
+        std::printf("Grafo de render (%dx%d, compilado %u veces): %zu pases, %zu texturas\n",
+                    compiledWidth, compiledHeight, compileCount, passes.size(), resources.size());
+        for (size_t p = 0; p < passes.size(); p++) {
+            const Pass& pass = passes[p];
+            std::printf("  [%zu] %s%s\n", p, pass.name.c_str(), pass.culled ? " (quitado: nadie usa su resultado)" : "");
+            if (pass.culled)
+                continue;
+            for (RenderGraphHandle h : pass.reads)
+                std::printf("      lee      %s\n", resources[h].name.c_str());
+            for (RenderGraphHandle h : pass.writes)
+                std::printf("      escribe  %s\n", resources[h].name.c_str());
+            for (const Barrier& b : pass.barriers)
+                std::printf("      barrera  %s: %s -> %s\n", resources[b.resource].name.c_str(), stateName(b.from), stateName(b.to));
+        }
+        for (const Resource& r : resources) {
+            if (r.imported) {
+                std::printf("  %-16s importada\n", r.name.c_str());
+            } else if (r.firstPass == NO_PASS) {
+                std::printf("  %-16s sin uso\n", r.name.c_str());
+            } else {
+                std::printf("  %-16s %s %dx%d, pases %u-%u, fisica #%u", r.name.c_str(), formatName(r.desc.format),
+                            resolveWidth(r.desc), resolveHeight(r.desc), r.firstPass, r.lastPass, r.physical);
+                const Resource* previous = nullptr; // Quién usaba esa memoria antes
+                for (const Resource& other : resources)
+                    if (&other != &r && !other.imported && other.physical == r.physical && other.lastPass < r.firstPass &&
+                        (!previous || other.lastPass > previous->lastPass))
+                        previous = &other;
+                if (previous)
+                    std::printf(" (reutiliza la de %s)", previous->name.c_str());
+                std::printf("\n");
+            }
+        }
+        std::printf("  Memoria: %zu KB declarados, %zu KB asignados en %zu texturas (%zu KB ahorrados al compartir)\n",
+                    virtualBytes / 1024, physicalBytes / 1024, physicals.size(), (virtualBytes - physicalBytes) / 1024);
+    }
+
+private:
+    static const uint32_t NO_PASS = 0xFFFFFFFFu;
+
+    struct Barrier {
+        RenderGraphHandle resource;
+        RenderGraphState from, to;
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<RenderGraphHandle> reads, writes;
+        std::vector<Barrier> barriers;
+        bool sideEffect = false;
+        bool culled = false;
+        GpuFramebuffer framebuffer; // Vacío si escribe al backbuffer
+    };
+
+    struct Resource {
+        std::string name;
+        RenderGraphTextureDesc desc;
+        bool imported = false;
+        GLuint importedTexture = 0;
+        uint32_t firstPass = NO_PASS, lastPass = NO_PASS;
+        uint32_t physical = NO_PASS;
+    };
+
+    // Textura de OpenGL que comparten las transitorias compatibles
+    struct Physical {
+        RenderGraphFormat format = RG_FORMAT_RGBA8;
+        int width = 0, height = 0;
+        uint32_t busyUntil = 0;     // Último pase de la transitoria que la ocupa ahora
+        GpuTexture texture;
+    };
+
+    std::vector<Pass> passes;
+    std::vector<Resource> resources;
+    std::vector<Physical> physicals;
+    int compiledWidth = 0, compiledHeight = 0;
+    unsigned compileCount = 0;
+    size_t virtualBytes = 0, physicalBytes = 0;
+
+    RenderGraphHandle addResource(const char* name, const RenderGraphTextureDesc& desc, bool imported, GLuint texture) {
+        Resource r;
+        r.name = name;
+        r.desc = desc;
+        r.imported = imported;
+        r.importedTexture = texture;
+        resources.push_back(r);
+        return (RenderGraphHandle)resources.size() - 1;
+    }
+
+    int resolveWidth(const RenderGraphTextureDesc& d) const {
+        return d.width > 0 ? d.width : std::max(1, (int)(compiledWidth * d.scale + 0.5f));
+    }
+    int resolveHeight(const RenderGraphTextureDesc& d) const {
+        return d.height > 0 ? d.height : std::max(1, (int)(compiledHeight * d.scale + 0.5f));
+    }
+
+    static size_t bytesPerPixel(RenderGraphFormat format) {
+        return format == RG_FORMAT_RGBA16F ? 8 : 4;
+    }
+
+    static const char* formatName(RenderGraphFormat format) {
+        static const char* const names[] = { "RGBA8", "RGBA16F", "DEPTH24", "R11G11B10F" };
+        return names[format];
+    }
+
+    static const char* stateName(RenderGraphState state) {
+        static const char* const names[] = { "indefinido", "destino", "lectura" };
+        return names[state];
+    }
+
+    // Recorrido de atrás hacia adelante: un pase sigue vivo si escribe una textura importada,
+    // tiene efectos laterales o escribe algo que lee un pase vivo posterior. Así también se
+    // quitan las cadenas que escriben varias veces la misma textura (ej. el bloom al subir)
+    // cuando nadie lee el resultado final.
+    void cullPasses() {
+        std::vector<bool> needed(resources.size(), false);
+        for (size_t p = passes.size(); p-- > 0;) {
+            Pass& pass = passes[p];
+            bool live = pass.sideEffect;
+            for (RenderGraphHandle h : pass.writes)
+                live = live || resources[h].imported || needed[h];
+            pass.culled = !live;
+            if (live)
+                for (RenderGraphHandle h : pass.reads)
+                    needed[h] = true;
+        }
+    }
+
+    void computeLifetimes() {
+        for (Resource& r : resources) {
+            r.firstPass = NO_PASS;
+            r.lastPass = NO_PASS;
+        }
+        for (uint32_t p = 0; p < passes.size(); p++) {
+            if (passes[p].culled)
+                continue;
+            auto touch = [this, p](RenderGraphHandle h) {
+                Resource& r = resources[h];
+                if (r.firstPass == NO_PASS)
+                    r.firstPass = p;
+                r.lastPass = p;
+            };
+            for (RenderGraphHandle h : passes[p].reads)
+                touch(h);
+            for (RenderGraphHandle h : passes[p].writes)
+                touch(h);
+        }
+    }
+
+    // Primera textura física libre y compatible; si no hay, una nueva. Las existentes se
+    // conservan entre compilaciones si el tamaño no cambió.
+    void assignPhysicalTextures() {
+        std::vector<Physical> previous;
+        previous.swap(physicals);
+        virtualBytes = 0;
+        physicalBytes = 0;
+        for (Resource& r : resources)
+            r.physical = NO_PASS;
+        for (uint32_t p = 0; p < passes.size(); p++) {
+            for (Resource& r : resources) {
+                if (r.imported || r.firstPass != p)
+                    continue;
+                int w = resolveWidth(r.desc), h = resolveHeight(r.desc);
+                size_t bytes = (size_t)w * h * bytesPerPixel(r.desc.format);
+                virtualBytes += bytes;
+                for (uint32_t i = 0; i < physicals.size(); i++) {
+                    Physical& candidate = physicals[i];
+                    if (candidate.busyUntil < p && candidate.format == r.desc.format && candidate.width == w && candidate.height == h) {
+                        r.physical = i;
+                        break;
+                    }
+                }
+                if (r.physical == NO_PASS) {
+                    Physical physical;
+                    physical.format = r.desc.format;
+                    physical.width = w;
+                    physical.height = h;
+                    physical.texture = takeOrCreate(previous, r.desc.format, w, h);
+                    physicals.push_back(physical);
+                    r.physical = (uint32_t)physicals.size() - 1;
+                    physicalBytes += bytes;
+                }
+                physicals[r.physical].busyUntil = r.lastPass;
+            }
+        }
+    }
+
+    static GpuTexture takeOrCreate(std::vector<Physical>& previous, RenderGraphFormat format, int w, int h) {
+        for (Physical& old : previous) {
+            if (old.texture && old.format == format && old.width == w && old.height == h) {
+                GpuTexture texture = std::move(old.texture);
+                return texture;
+            }
+        }
+        static const GLenum internalFormats[] = { GL_RGBA8, GL_RGBA16F, GL_DEPTH_COMPONENT24, GL_R11F_G11F_B10F };
+        static const GLenum formats[] = { GL_RGBA, GL_RGBA, GL_DEPTH_COMPONENT, GL_RGB };
+        static const GLenum types[] = { GL_UNSIGNED_BYTE, GL_HALF_FLOAT, GL_UNSIGNED_INT, GL_FLOAT };
+        GpuTexture texture = GpuTexture::generate();
+        glBindTexture(GL_TEXTURE_2D, texture.id());
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[format], w, h, 0, formats[format], types[format], nullptr);
+        GLint filter = format == RG_FORMAT_DEPTH24 ? GL_NEAREST : GL_LINEAR;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texture;
+    }
+
+    void computeBarriers() {
+        std::vector<RenderGraphState> state(resources.size(), RG_STATE_UNDEFINED);
+        for (Pass& pass : passes) {
+            pass.barriers.clear();
+            if (pass.culled)
+                continue;
+            auto transition = [&](RenderGraphHandle h, RenderGraphState to) {
+                if (state[h] != to) {
+                    pass.barriers.push_back({ h, state[h], to });
+                    state[h] = to;
+                }
+            };
+            for (RenderGraphHandle h : pass.reads)
+                transition(h, RG_STATE_SHADER_READ);
+            for (RenderGraphHandle h : pass.writes)
+                transition(h, RG_STATE_ATTACHMENT);
+        }
+    }
+
+    void createFramebuffers() {
+        for (Pass& pass : passes) {
+            pass.framebuffer = GpuFramebuffer();
+            if (pass.culled || pass.writes.empty())
+                continue;
+            bool toBackbuffer = false;
+            for (RenderGraphHandle h : pass.writes)
+                toBackbuffer |= resources[h].imported && resources[h].importedTexture == 0;
+            if (toBackbuffer)
+                continue;
+
+            pass.framebuffer = GpuFramebuffer::generate();
+            glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer.id());
+            GLenum drawBuffers[8];
+            GLsizei colorCount = 0;
+            for (RenderGraphHandle h : pass.writes) {
+                GLenum attachment = resources[h].desc.format == RG_FORMAT_DEPTH24 ? GL_DEPTH_ATTACHMENT
+                                                                                 : GL_COLOR_ATTACHMENT0 + colorCount;
+                if (attachment != GL_DEPTH_ATTACHMENT && colorCount < 8)
+                    drawBuffers[colorCount++] = attachment;
+                glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture(h), 0);
+            }
+            if (colorCount > 0) {
+                glDrawBuffers(colorCount, drawBuffers);
+            } else {
+                glDrawBuffer(GL_NONE);
+                glReadBuffer(GL_NONE);
+            }
+            GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE)
+                std::cout << "ERROR::RENDER_GRAPH::FRAMEBUFFER_INCOMPLETE: " << pass.name << " 0x" << std::hex << status << std::dec << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+};
+
+inline GLuint RenderGraphContext::texture(RenderGraphHandle handle) const { return graph->texture(handle); }
+inline int RenderGraphContext::textureWidth(RenderGraphHandle handle) const { return graph->textureWidth(handle); }
+inline int RenderGraphContext::textureHeight(RenderGraphHandle handle) const { return graph->textureHeight(handle); }
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Grass.h"
+#include "LightClusters.h"
+#include "ParticleSystem.h"
+#include "Terrain.h"
+#include "VertexAnimation.h"
+
+#include <cstdint>
+#include <vector>
+
+// Todo lo que el hilo de render necesita para dibujar un frame. La simulación lo llena
+// cada tick y lo entrega por un TripleBuffer, así el render nunca lee el estado global.
+struct RenderSnapshot {
+    uint64_t frameIndex = 0;
+    float time = 0.0f;  // Segundos simulados (animaciones en la GPU)
+
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+
+    // Goku
+    glm::vec3 gokuPos = glm::vec3(0.0f);
+    glm::mat4 gokuModel = glm::mat4(1.0f);  // Mundo del nodo de la malla (sin los nodos del FBX)
+    bool gokuMoving = false;
+    bool gokuVisible = true;   // Dentro de la cámara y sin oclusores delante
+
+    // Escenario
+    glm::mat4 skyModel = glm::mat4(1.0f);
+    glm::vec3 shadowCenter = glm::vec3(0.0f);  // Centro del cuadro de las sombras (en saltos de un chunk)
+    uint32_t staticGeometryVersion = 0;  // Cambia si hay que redibujar las sombras estáticas
+
+    // Terreno: chunks visibles (con su LOD) y los que proyectan sombra (mapa estático)
+    std::vector<TerrainDraw> terrainChunks;
+    std::vector<TerrainDraw> terrainShadowChunks;
+    // Pasto: chunks cercanos con cuántas hojas dibujar de cada uno
+    std::vector<GrassDraw> grassChunks;
+
+    // Ataques: una matriz model por proyectil visible (se dibujan instanciados)
+    std::vector<glm::mat4> projectileModels;
+
+    // Multitud: sólo los que pasaron el culling
+    std::vector<VatInstance> crowdInstances;
+
+    // Lo que se mueve y proyecta sombra: probado contra el cuadro de las sombras visto desde
+    // el sol, no contra la cámara (la sombra de algo fuera de pantalla puede caer dentro)
+    std::vector<glm::mat4> projectileShadowModels;
+    std::vector<VatInstance> crowdShadowInstances;
+
+    // Luces puntuales ya repartidas en clusters (el render sólo las sube)
+    LightClusterData lightClusters;
+
+    // Partículas vivas (la capacidad se reserva una vez y se reutiliza cada frame)
+    std::vector<ParticleInstance> particles;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+// Jerarquía de transformaciones plana.
+//
+// Los nodos viven en arreglos contiguos (padre, matriz local, matriz de mundo) y siempre
+// se agregan después de su padre, así el orden de los arreglos ya es topológico: una sola
+// pasada calcula cada mundo con el del padre ya listo. Sólo se recalculan los nodos
+// marcados como sucios y sus descendientes, y la pasada empieza en el primer nodo sucio
+// (ningún nodo anterior puede depender de él).
+//
+//   uint32_t goku = scene.addNode(SceneGraph::NO_PARENT);
+//   uint32_t mano = scene.addNode(goku, offset);
+//   scene.setLocal(goku, nuevaMatriz);  // marca goku (y por lo tanto mano)
+//   scene.update();
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class SceneGraph {
+public:
+    static constexpr uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+    void reserve(size_t count) {
+        parents.reserve(count);
+        locals.reserve(count);
+        worlds.reserve(count);
+        dirty.reserve(count);
+    }
+
+    // El padre tiene que existir (o ser NO_PARENT): así el índice del hijo siempre es mayor
+    uint32_t addNode(uint32_t parent, const glm::mat4& local = glm::mat4(1.0f)) {
+        uint32_t index = (uint32_t)parents.size();
+        parents.push_back(parent < index ? parent : NO_PARENT);
+        locals.push_back(local);
+        worlds.push_back(local);
+        dirty.push_back(1);
+        markDirty(index);
+        return index;
+    }
+
+    // Sólo marca el nodo si la matriz realmente cambió
+    void setLocal(uint32_t node, const glm::mat4& local) {
+        if (std::memcmp(&locals[node], &local, sizeof(glm::mat4)) == 0)
+            return;
+        locals[node] = local;
+        dirty[node] = 1;
+        markDirty(node);
+    }
+
+    // Recalcula los mundos de los nodos sucios y sus descendientes; devuelve cuántos
+    size_t update() {
+        if (firstDirty == NO_PARENT)
+            return 0;
+        size_t recomputed = 0;
+        size_t count = parents.size();
+        for (size_t i = firstDirty; i < count; i++) {
+            uint32_t parent = parents[i];
+            // El padre está antes en el arreglo: si cambió en esta pasada, su marca sigue puesta
+            if (parent != NO_PARENT && dirty[parent])
+                dirty[i] = 1;
+            if (!dirty[i])
+                continue;
+            worlds[i] = parent == NO_PARENT ? locals[i] : worlds[parent] * locals[i];
+            recomputed++;
+        }
+        std::memset(dirty.data() + firstDirty, 0, count - firstDirty);
+        firstDirty = NO_PARENT;
+        return recomputed;
+    }
+
+    const glm::mat4& local(uint32_t node) const { return locals[node]; }
+    const glm::mat4& world(uint32_t node) const { return worlds[node]; }
+    uint32_t parent(uint32_t node) const { return parents[node]; }
+    size_t size() const { return parents.size(); }
+
+    void clear() {
+        parents.clear();
+        locals.clear();
+        worlds.clear();
+        dirty.clear();
+        firstDirty = NO_PARENT;
+    }
+
+private:
+    std::vector<uint32_t>  parents;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<uint8_t>   dirty;
+    uint32_t firstDirty = NO_PARENT; // NO_PARENT = nada que actualizar
+
+    void markDirty(uint32_t node) {
+        if (firstDirty == NO_PARENT || node < firstDirty)
+            firstDirty = node;
+    }
+};
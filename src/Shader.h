@@ -4,7 +4,12 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "GLExtensions.h"
+#include "GpuResources.h"
+#include "ShaderCache.h"
+
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -12,55 +17,28 @@
 class Shader {
 public:
     unsigned int ID;
+    GpuProgram program; // Dueño de ID: las copias de un Shader comparten el programa
+
+    Shader() : ID(0) {}
+
+    // Toma posesión de un programa ya enlazado (lo usa ShaderPermutations)
+    explicit Shader(unsigned int programID) : ID(programID), program(GpuProgram::adopt(programID)) {}
 
     // Constructor
     Shader(const char* vertexPath, const char* fragmentPath) {
         // 1. Recuperar el código fuente
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        
-        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        try {
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            vShaderFile.close();
-            fShaderFile.close();
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-        }
-        catch (std::ifstream::failure& e) {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
+        std::string vertexCode = readFile(vertexPath);
+        std::string fragmentCode = readFile(fragmentPath);
+
+        // 2. Intentar el binario guardado de una ejecución anterior
+        uint64_t cacheKey = ShaderCache::makeKey(vertexCode, fragmentCode);
+        if (!loadCached(cacheKey, ID)) {
+            // 3. Compilar shaders y enlazar
+            unsigned int vertex, fragment;
+            ID = beginLink(vertexCode, fragmentCode, vertex, fragment);
+            finishLink(ID, vertex, fragment, cacheKey);
         }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
-        
-        // 2. Compilar shaders
-        unsigned int vertex, fragment;
-        
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        program = GpuProgram::adopt(ID);
     }
     
     void use() const { 
@@ -77,15 +55,135 @@ public:
     void setFloat(const std::string &name, float value) const { 
         glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
     }
+    void setVec2(const std::string &name, const glm::vec2 &value) const {
+        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    }
     void setVec3(const std::string &name, const glm::vec3 &value) const { 
         glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
     }
+    void setVec4(const std::string &name, const glm::vec4 &value) const {
+        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    }
     void setMat4(const std::string &name, const glm::mat4 &mat) const {
         glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
     }
 
+    // Versiones con const char*: con un literal ("model") evitan construir un std::string
+    // temporal (una asignación de heap por llamada si no cabe en el SSO)
+    void setBool(const char *name, bool value) const {
+        glUniform1i(glGetUniformLocation(ID, name), (int)value);
+    }
+    void setInt(const char *name, int value) const {
+        glUniform1i(glGetUniformLocation(ID, name), value);
+    }
+    void setFloat(const char *name, float value) const {
+        glUniform1f(glGetUniformLocation(ID, name), value);
+    }
+    void setVec2(const char *name, const glm::vec2 &value) const {
+        glUniform2fv(glGetUniformLocation(ID, name), 1, &value[0]);
+    }
+    void setVec3(const char *name, const glm::vec3 &value) const {
+        glUniform3fv(glGetUniformLocation(ID, name), 1, &value[0]);
+    }
+    void setVec4(const char *name, const glm::vec4 &value) const {
+        glUniform4fv(glGetUniformLocation(ID, name), 1, &value[0]);
+    }
+    void setMat4(const char *name, const glm::mat4 &mat) const {
+        glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    // Asocia un bloque de uniforms del shader a un punto de enlace (ver UniformBlocks.h)
+    void bindUniformBlock(const char *name, unsigned int binding) const {
+        GLuint index = glGetUniformBlockIndex(ID, name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+
+    static std::string readFile(const char* path) {
+        std::ifstream file;
+        file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try {
+            file.open(path);
+            std::stringstream stream;
+            stream << file.rdbuf();
+            file.close();
+            return stream.str();
+        }
+        catch (std::ifstream::failure& e) {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << " " << e.what() << std::endl;
+        }
+        return std::string();
+    }
+
+    // Inserta "#define X" justo después de la línea #version del código GLSL
+    static std::string injectDefines(const std::string& source, const std::vector<std::string>& defines) {
+        if (defines.empty())
+            return source;
+        size_t versionLine = source.find("#version");
+        size_t insertAt = versionLine == std::string::npos ? 0 : source.find('\n', versionLine);
+        insertAt = insertAt == std::string::npos ? source.size() : insertAt + 1;
+
+        std::string block;
+        for (const std::string& d : defines)
+            block += "#define " + d + "\n";
+        // Mantiene los números de línea de los errores iguales a los del archivo original
+        block += "#line 2\n";
+        return source.substr(0, insertAt) + block + source.substr(insertAt);
+    }
+
+    // Carga un programa desde la caché; si no está (o el driver lo rechaza) devuelve false
+    static bool loadCached(uint64_t cacheKey, unsigned int& program) {
+        program = glCreateProgram();
+        if (ShaderCache::load(cacheKey, program))
+            return true;
+        glDeleteProgram(program);
+        program = 0;
+        return false;
+    }
+
+    // Manda a compilar y enlazar sin consultar el estado: así el driver puede trabajar
+    // en paralelo mientras pedimos más programas. El resultado lo revisa finishLink.
+    static unsigned int beginLink(const std::string& vertexCode, const std::string& fragmentCode,
+                                  unsigned int& vertex, unsigned int& fragment) {
+        const char* vShaderCode = vertexCode.c_str();
+        const char * fShaderCode = fragmentCode.c_str();
+
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        if (glExt.programBinary)
+            glExt.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+        return program;
+    }
+
+    // Revisa errores (esto sí espera al driver), guarda el binario y libera los shaders
+    static bool finishLink(unsigned int program, unsigned int vertex, unsigned int fragment, uint64_t cacheKey) {
+        bool linked = checkCompileErrors(program, "PROGRAM");
+        if (linked)
+            ShaderCache::store(cacheKey, program);
+        else {
+            checkCompileErrors(vertex, "VERTEX");
+            checkCompileErrors(fragment, "FRAGMENT");
+        }
+        glDetachShader(program, vertex);
+        glDetachShader(program, fragment);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return linked;
+    }
+
 private:
-    void checkCompileErrors(unsigned int shader, std::string type) {
+    // Devuelve true si la compilación/enlace fue exitoso
+    static bool checkCompileErrors(unsigned int shader, std::string type) {
         int success;
         char infoLog[1024];
         if (type != "PROGRAM") {
@@ -102,6 +200,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
     }
 };
 #endif
\ No newline at end of file
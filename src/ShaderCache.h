@@ -0,0 +1,125 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "GLExtensions.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <iostream>
+
+// Caché en disco de programas ya enlazados (glGetProgramBinary / glProgramBinary).
+// La llave combina el código fuente de los shaders con vendor/renderer/versión del driver,
+// así un cambio de GPU o de driver simplemente no encuentra el archivo y se recompila.
+class ShaderCache {
+public:
+    static constexpr const char* DIRECTORY = "shader_cache";
+
+    // FNV-1a de 64 bits: suficiente para distinguir fuentes y es trivial de implementar
+    static uint64_t hash(const void* data, size_t size, uint64_t h = 1469598103934665603ull) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+    static uint64_t hash(const std::string& s, uint64_t h) {
+        // Incluimos el terminador para que "ab"+"c" no choque con "a"+"bc"
+        return hash(s.c_str(), s.size() + 1, h);
+    }
+
+    static uint64_t makeKey(const std::string& vertexCode, const std::string& fragmentCode) {
+        uint64_t h = hash(vertexCode, 1469598103934665603ull);
+        h = hash(fragmentCode, h);
+        h = hash(glString(GL_VENDOR), h);
+        h = hash(glString(GL_RENDERER), h);
+        h = hash(glString(GL_VERSION), h);
+        return h;
+    }
+
+    // Intenta cargar el binario en 'program'. Si el driver lo rechaza devuelve false
+    // y el programa queda sin enlazar, listo para compilarse desde el código fuente.
+    static bool load(uint64_t key, unsigned int program) {
+        if (!glExt.programBinary)
+            return false;
+
+        FILE* file = std::fopen(pathFor(key).c_str(), "rb");
+        if (!file)
+            return false;
+
+        Header header = {};
+        std::vector<char> binary;
+        bool ok = std::fread(&header, sizeof(Header), 1, file) == 1 &&
+                  header.magic == MAGIC && header.key == key && header.length > 0;
+        if (ok) {
+            binary.resize(header.length);
+            ok = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+        }
+        std::fclose(file);
+        if (!ok)
+            return false;
+
+        glExt.ProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        return success != 0;
+    }
+
+    // Guarda el binario de un programa ya enlazado (creado con la pista RETRIEVABLE)
+    static void store(uint64_t key, unsigned int program) {
+        if (!glExt.programBinary)
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        Header header = {};
+        header.magic = MAGIC;
+        header.key = key;
+        std::vector<char> binary(length);
+        GLsizei written = 0;
+        glExt.GetProgramBinary(program, length, &written, &header.format, binary.data());
+        if (written <= 0)
+            return;
+        header.length = (uint32_t)written;
+
+        std::error_code ec;
+        std::filesystem::create_directories(DIRECTORY, ec);
+        FILE* file = std::fopen(pathFor(key).c_str(), "wb");
+        if (!file) {
+            std::cout << "ERROR::SHADER_CACHE::NO_SE_PUDO_ESCRIBIR: " << pathFor(key) << std::endl;
+            return;
+        }
+        std::fwrite(&header, sizeof(Header), 1, file);
+        std::fwrite(binary.data(), 1, header.length, file);
+        std::fclose(file);
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x42504B47; // "GKPB"
+
+    struct Header {
+        uint32_t magic;
+        GLenum   format;
+        uint64_t key;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    static std::string glString(GLenum name) {
+        const char* s = (const char*)glGetString(name);
+        return s ? s : "";
+    }
+
+    static std::string pathFor(uint64_t key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return std::string(DIRECTORY) + "/" + name;
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "GLExtensions.h"
+#include "Shader.h"
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+// Características que se activan con #define en basic.vert / basic.frag
+enum ShaderFeature : uint32_t {
+    SHADER_SKINNED    = 1 << 0, // Skinning por huesos (atributos 3 y 4, uniform bones[])
+    SHADER_INSTANCED  = 1 << 1, // Matriz model por instancia (atributos 5..8)
+    SHADER_ALPHA_TEST = 1 << 2, // discard si alpha < alphaCutoff
+    SHADER_OUTLINE    = 1 << 3, // Color sólido para el contorno (reemplaza outline.vert/frag)
+    SHADER_VERTEX_ANIMATION = 1 << 4, // Posición/normal de texturas VAT (con INSTANCED; atributo 9)
+    SHADER_CLUSTERED_LIGHTS = 1 << 5, // Luces puntuales por cluster (texturas 3..5, LightClusterBuffers)
+    SHADER_EMISSIVE   = 1 << 6, // Sin iluminación, textura * emissiveStrength (pasa el umbral del bloom)
+    SHADER_SHADOWS    = 1 << 7, // Recibe sombras del sol (textura 6, ShadowMap)
+    SHADER_DEPTH_ONLY = 1 << 8  // Sólo profundidad: para dibujar los oclusores en el mapa de sombras
+};
+
+static const char* const SHADER_FEATURE_DEFINES[] = { "SKINNED", "INSTANCED", "ALPHA_TEST", "OUTLINE", "VERTEX_ANIMATION", "CLUSTERED_LIGHTS", "EMISSIVE", "SHADOWS", "DEPTH_ONLY" };
+static const uint32_t SHADER_FEATURE_COUNT = 9;
+
+// Un par vertex/fragment compilado en todas las variantes que se pidan, indexadas por máscara
+// de ShaderFeature. Las variantes se compilan juntas al inicio: primero se mandan todas al
+// driver y después se espera el resultado, en vez de compilar y revisar una por una.
+class ShaderPermutations {
+public:
+    ShaderPermutations(const char* vertexPath, const char* fragmentPath)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath) {
+        vertexSource = Shader::readFile(vertexPath);
+        fragmentSource = Shader::readFile(fragmentPath);
+    }
+
+    // Marca una variante para compilarla en el siguiente compileAll() (pedirla dos veces no
+    // la compila dos veces)
+    void request(uint32_t mask) {
+        if (programs.find(mask) == programs.end() && std::find(pending.begin(), pending.end(), mask) == pending.end())
+            pending.push_back(mask);
+    }
+
+    void compileAll() {
+        struct InFlight {
+            uint32_t mask;
+            uint64_t key;
+            unsigned int program, vertex, fragment;
+        };
+        std::vector<InFlight> inFlight;
+
+        // 1. Caché de binarios primero; lo que no esté se manda a compilar sin esperar
+        for (uint32_t mask : pending) {
+            if (programs.find(mask) != programs.end())
+                continue;
+            std::vector<std::string> defines = definesFor(mask);
+            std::string vertexCode = Shader::injectDefines(vertexSource, defines);
+            std::string fragmentCode = Shader::injectDefines(fragmentSource, defines);
+            uint64_t key = ShaderCache::makeKey(vertexCode, fragmentCode);
+
+            unsigned int program;
+            if (Shader::loadCached(key, program)) {
+                programs[mask] = Shader(program);
+                continue;
+            }
+            InFlight f = { mask, key, 0, 0, 0 };
+            f.program = Shader::beginLink(vertexCode, fragmentCode, f.vertex, f.fragment);
+            inFlight.push_back(f);
+        }
+        pending.clear();
+
+        // 2. Recoger resultados. Con GL_KHR_parallel_shader_compile preguntamos sin bloquear y
+        //    tomamos los programas en el orden en que terminan; sin la extensión revisamos en
+        //    orden de envío (el driver igual pudo avanzar con los demás mientras tanto).
+        while (!inFlight.empty()) {
+            bool progressed = false;
+            for (size_t i = 0; i < inFlight.size();) {
+                InFlight& f = inFlight[i];
+                if (glExt.parallelShaderCompile) {
+                    GLint done = GL_FALSE;
+                    glGetProgramiv(f.program, GL_COMPLETION_STATUS_KHR, &done);
+                    if (!done) { i++; continue; }
+                }
+                if (!Shader::finishLink(f.program, f.vertex, f.fragment, f.key))
+                    std::cout << "ERROR::SHADER_PERMUTATION: " << vertexPath << " / " << fragmentPath
+                              << " variante " << describe(f.mask) << std::endl;
+                programs[f.mask] = Shader(f.program);
+                inFlight[i] = inFlight.back();
+                inFlight.pop_back();
+                progressed = true;
+            }
+            if (!progressed)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // Devuelve la variante; si no se pidió antes se compila en el momento
+    Shader& get(uint32_t mask) {
+        auto it = programs.find(mask);
+        if (it != programs.end())
+            return it->second;
+        request(mask);
+        compileAll();
+        return programs[mask];
+    }
+
+    static std::vector<std::string> definesFor(uint32_t mask) {
+        std::vector<std::string> defines;
+        for (uint32_t i = 0; i < SHADER_FEATURE_COUNT; i++)
+            if (mask & (1u << i))
+                defines.push_back(SHADER_FEATURE_DEFINES[i]);
+        return defines;
+    }
+
+    static std::string describe(uint32_t mask) {
+        std::string text;
+        for (const std::string& d : definesFor(mask))
+            text += (text.empty() ? "" : "|") + d;
+        return text.empty() ? "BASE" : text;
+    }
+
+private:
+    std::string vertexPath, fragmentPath;
+    std::string vertexSource, fragmentSource;
+    std::vector<uint32_t> pending;
+    std::map<uint32_t, Shader> programs;
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+// Sombras del sol con un mapa estático en caché y otro dinámico por frame.
+//
+// Los dos mapas cubren el mismo cuadro del mundo visto desde el sol, así que comparten
+// matriz y se pueden combinar con una copia:
+//   - "sombras_estaticas": el suelo y lo que no se mueve. Sólo se vuelve a dibujar si
+//     cambia la dirección de la luz, el centro del cuadro o la versión de la geometría
+//     estática que publica la simulación; el resto de los frames el pase no hace nada.
+//   - "sombras_dinamicas": copia el mapa estático (glBlitFramebuffer de profundidad, sin
+//     shaders) y encima dibuja sólo lo que se mueve (Goku, la multitud, los proyectiles).
+// El resultado es una textura transitoria del grafo que la escena lee con PCF (basic.frag,
+// variante SHADOWS).
+//
+// Un solo nivel (sin cascadas): el cuadro mide 110 x 110 alrededor del jugador y un mapa
+// de 2048 da texels de unos 5 cm. La simulación mueve el centro en saltos de un chunk del
+// terreno, así el mapa estático se redibuja sólo al cruzar de chunk y no en cada paso.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "GpuResources.h"
+#include "RenderGraph.h"
+#include "Shader.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+
+// Unidad de textura del mapa de sombras (0 difusa, 1-2 VAT, 3-5 luces por cluster)
+static const int SHADOW_MAP_UNIT = 6;
+
+struct ShadowSettings {
+    int resolution = 2048;
+    float halfExtent = 55.0f;              // Medio lado del cuadro cubierto (centrado en setLight)
+    float depthBias = 2.0f, slopeBias = 4.0f; // glPolygonOffset al dibujar los oclusores
+};
+
+class ShadowMap {
+public:
+    typedef std::function<void()> DrawFunction;
+    ShadowSettings settings;
+
+    // Hilo con el contexto
+    void init(const ShadowSettings& newSettings) {
+        settings = newSettings;
+        staticDepth = GpuTexture::generate();
+        glBindTexture(GL_TEXTURE_2D, staticDepth.id());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, settings.resolution, settings.resolution, 0,
+                     GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // Origen de la copia al mapa dinámico
+        copySource = GpuFramebuffer::generate();
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, copySource.id());
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, staticDepth.id(), 0);
+        glReadBuffer(GL_NONE);
+        GLenum status = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "ERROR::SHADOW_MAP::FRAMEBUFFER_INCOMPLETE: 0x" << std::hex << status << std::dec << std::endl;
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    }
+
+    // Una vez por shader que use SHADOWS
+    static void bindSampler(Shader& shader) {
+        shader.use();
+        shader.setInt("shadowMap", SHADOW_MAP_UNIT);
+    }
+
+    // Al inicio de cada frame: con otra dirección, otro centro u otra geometría estática el
+    // caché no sirve
+    void setLight(const glm::vec3& towardLight, const glm::vec3& center, uint32_t staticVersion) {
+        glm::vec3 direction = glm::normalize(towardLight);
+        if (staticValid && direction == lightDirection && center == boxCenter && staticVersion == staticGeometryVersion)
+            return;
+        lightDirection = direction;
+        boxCenter = center;
+        staticGeometryVersion = staticVersion;
+        staticValid = false;
+        lightMatrices(direction, center, settings.halfExtent, view, projection);
+    }
+
+    // Vista y proyección del cuadro desde el sol. La simulación arma con ellas el frustum
+    // con el que elige lo que proyecta sombra, sin depender de lo que ve la cámara.
+    static void lightMatrices(const glm::vec3& towardLight, const glm::vec3& center, float halfExtent,
+                              glm::mat4& lightView, glm::mat4& lightProjection) {
+        glm::vec3 direction = glm::normalize(towardLight);
+        float e = halfExtent;
+        glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        lightView = glm::lookAt(center + direction * (2.0f * e), center, up);
+        lightProjection = glm::ortho(-e, e, -e, e, 0.1f, 4.0f * e);
+    }
+
+    const glm::mat4& lightView() const { return view; }
+    const glm::mat4& lightProjection() const { return projection; }
+    glm::mat4 lightSpace() const { return projection * view; }
+
+    // Agrega los dos pases; devuelve el mapa combinado que debe leer la escena
+    RenderGraphHandle addPasses(RenderGraph& graph, DrawFunction drawStatic, DrawFunction drawDynamic) {
+        RenderGraphTextureDesc desc;
+        desc.format = RG_FORMAT_DEPTH24;
+        desc.width = desc.height = settings.resolution;
+        RenderGraphHandle staticMap = graph.importTexture("shadowStatic", staticDepth.id(), desc);
+        RenderGraphHandle shadowMap = RG_INVALID_HANDLE;
+
+        graph.addPass("sombras_estaticas",
+            [&](RenderGraph::Builder& pass) { pass.write(staticMap); },
+            [this, drawStatic](const RenderGraphContext&) {
+                if (staticValid)
+                    return;
+                beginCasters();
+                glClear(GL_DEPTH_BUFFER_BIT);
+                drawStatic();
+                endCasters();
+                staticValid = true;
+                staticRenders++;
+            });
+        graph.addPass("sombras_dinamicas",
+            [&](RenderGraph::Builder& pass) {
+                shadowMap = pass.create("shadowMap", desc);
+                pass.read(staticMap);
+                pass.write(shadowMap);
+            },
+            [this, drawDynamic](const RenderGraphContext&) {
+                int size = settings.resolution;
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, copySource.id());
+                glBlitFramebuffer(0, 0, size, size, 0, 0, size, size, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+                beginCasters();
+                drawDynamic();
+                endCasters();
+                dynamicRenders++;
+            });
+        return shadowMap;
+    }
+
+    // Deja el mapa combinado en su unidad, con comparación de profundidad para sampler2DShadow
+    void bind(GLuint shadowTexture) const {
+        glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_UNIT);
+        glBindTexture(GL_TEXTURE_2D, shadowTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void report() const {
+        std::printf("Sombras: mapa %dx%d | estatico redibujado %llu veces en %llu frames\n",
+                    settings.resolution, settings.resolution, (unsigned long long)staticRenders,
+                    (unsigned long long)dynamicRenders);
+    }
+
+private:
+    GpuTexture staticDepth;
+    GpuFramebuffer copySource;
+    glm::vec3 lightDirection = glm::vec3(0.0f), boxCenter = glm::vec3(0.0f);
+    glm::mat4 view = glm::mat4(1.0f), projection = glm::mat4(1.0f);
+    uint32_t staticGeometryVersion = 0;
+    bool staticValid = false;
+    uint64_t staticRenders = 0, dynamicRenders = 0;
+
+    // Sin color, sin culling (el suelo es una sola cara) y con sesgo contra el acné
+    void beginCasters() {
+        glViewport(0, 0, settings.resolution, settings.resolution);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(settings.depthBias, settings.slopeBias);
+    }
+
+    void endCasters() {
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glEnable(GL_CULL_FACE);
+    }
+};
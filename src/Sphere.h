@@ -5,30 +5,48 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "GpuResources.h"
+
 class Sphere {
 public:
-    // Configuración de la esfera
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    unsigned int VAO;
+    GpuVertexArray VAO;
+    unsigned int indexCount = 0;
 
-    // Constructor: Radio, sectores (cortes verticales), stacks (cortes horizontales)
+    // Constructor: Radio, sectores (cortes verticales), stacks (cortes horizontales).
+    // La geometría de CPU es temporal: después de subirla sólo queda el VAO.
     Sphere(float radius = 1.0f, int sectorCount = 36, int stackCount = 18) {
-        buildVerticesSmooth(radius, sectorCount, stackCount);
-        setupSphere();
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        buildVerticesSmooth(radius, sectorCount, stackCount, vertices, indices);
+        setupSphere(vertices, indices);
     }
 
+
     void Draw() {
-        glBindVertexArray(VAO);
+        glBindVertexArray(VAO.id());
         // Dibujamos usando índices (Elements)
-        glDrawElements(GL_TRIANGLES, (unsigned int)indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
     }
 
-private:
-    unsigned int VBO, EBO;
+    // Una esfera por instancia; la matriz model de cada una está en 'instanceBuffer' a partir
+    // de 'offset' (mat4 seguidas, locations 5..8 de la variante INSTANCED de basic.vert)
+    void DrawInstanced(GLuint instanceBuffer, GLintptr offset, GLsizei count) {
+        glBindVertexArray(VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (int column = 0; column < 4; column++) {
+            glEnableVertexAttribArray(5 + column);
+            glVertexAttribPointer(5 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(offset + column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(5 + column, 1);
+        }
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, count);
+        glBindVertexArray(0);
+    }
 
-    void buildVerticesSmooth(float radius, int sectorCount, int stackCount) {
+    // Genera la geometría en CPU (sin tocar OpenGL), así también se puede medir aparte
+    static void buildVerticesSmooth(float radius, int sectorCount, int stackCount,
+                                    std::vector<float>& vertices, std::vector<unsigned int>& indices) {
         float x, y, z, xy;                              // Posición del vértice
         float nx, ny, nz, lengthInv = 1.0f / radius;    // Normales
         float s, t;                                     // Coordenadas de textura (UV)
@@ -37,6 +55,10 @@ private:
         float stackStep = 3.14159f / stackCount;
         float sectorAngle, stackAngle;
 
+        // 8 floats por vértice; a lo más 6 índices por cuadro (los polos usan 3)
+        vertices.reserve(vertices.size() + (size_t)(stackCount + 1) * (sectorCount + 1) * 8);
+        indices.reserve(indices.size() + (size_t)stackCount * sectorCount * 6);
+
         for (int i = 0; i <= stackCount; ++i) {
             stackAngle = 3.14159f / 2 - i * stackStep;  // de pi/2 a -pi/2
             xy = radius * cosf(stackAngle);             // r * cos(u)
@@ -93,18 +115,22 @@ private:
         }
     }
 
-    void setupSphere() {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+private:
+    GpuBuffer VBO, EBO;
+
+    void setupSphere(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+        VAO = GpuVertexArray::generate();
+        VBO = GpuBuffer::generate();
+        EBO = GpuBuffer::generate();
 
-        glBindVertexArray(VAO);
+        glBindVertexArray(VAO.id());
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO.id());
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.id());
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        indexCount = (unsigned int)indices.size();
 
         // Stride: 3 (Pos) + 3 (Norm) + 2 (Tex) = 8 floats
         long stride = 8 * sizeof(float);
@@ -0,0 +1,202 @@
+#pragma once
+
+// Búfer circular para datos dinámicos que cambian cada frame (bloques de uniforms, matrices
+// por instancia, paletas de huesos, partículas...).
+//
+// Un solo búfer de OpenGL dividido en REGIONS regiones; cada frame escribe en la siguiente.
+// Al terminar el frame se pone un fence en su región y, antes de volver a escribir en ella
+// (REGIONS frames después), se espera ese fence: si la GPU todavía no terminó se cuenta un
+// stall. Dentro de la región las asignaciones sólo avanzan un offset (alineado a lo que
+// pida cada uso: UBO, SSBO o vértices).
+//
+// Con GL_ARB_buffer_storage el búfer queda mapeado para siempre (PERSISTENT | COHERENT) y
+// allocate() devuelve un puntero directo a la memoria que lee la GPU. En 3.3 puro se escribe
+// en una copia en CPU y commit() la sube con glBufferSubData a la región del frame.
+//
+// Sólo lo usa el hilo de render (el dueño del contexto).
+
+#include <glad/glad.h>
+
+#include "GLExtensions.h"
+#include "GpuResources.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+// Un pedazo del búfer válido durante el frame en que se pidió
+struct StreamAllocation {
+    void* data = nullptr;
+    GLintptr offset = 0;  // Offset dentro de StreamBuffer::buffer()
+    GLsizeiptr size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+class StreamBuffer {
+public:
+    static constexpr unsigned int REGIONS = 3;
+
+    StreamBuffer() = default;
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Hilo con el contexto
+    void init(size_t bytesPerRegion) {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        uniformAlignment = (size_t)alignment;
+        if (glExt.shaderStorage) {
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            storageAlignment = (size_t)alignment;
+        }
+
+        // Cada región empieza alineada para cualquier uso
+        regionSize = alignUp(bytesPerRegion, uniformAlignment > storageAlignment ? uniformAlignment : storageAlignment);
+        GLsizeiptr totalSize = (GLsizeiptr)(regionSize * REGIONS);
+
+        buffer = GpuBuffer::generate();
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.id());
+        persistent = glExt.bufferStorage;
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glExt.BufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+            mapped = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags));
+            if (!mapped) {
+                std::cout << "ERROR::STREAM_BUFFER::MAP_FAILED: se usa glBufferSubData" << std::endl;
+                // Un búfer con almacenamiento inmutable no se puede redimensionar: uno nuevo
+                buffer = GpuBuffer::generate();
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.id());
+                persistent = false;
+            }
+        }
+        if (!persistent) {
+            glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+            shadow.assign(regionSize, 0);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    // Pasa a la siguiente región; si la GPU todavía la está leyendo hay que esperarla
+    void beginFrame() {
+        region = (region + 1) % REGIONS;
+        offset = 0;
+        committed = 0;
+        GLsync& fence = fences[region];
+        if (!fence)
+            return;
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            stalls++;
+            auto start = std::chrono::high_resolution_clock::now();
+            GLenum status;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+            } while (status == GL_TIMEOUT_EXPIRED);
+            stallSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // Después del último draw que lee la región de este frame
+    void endFrame() {
+        commit();
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (offset > peakBytes)
+            peakBytes = offset;
+        frames++;
+    }
+
+    // Espacio en la región del frame; data == nullptr si ya no cabe
+    StreamAllocation allocate(size_t size, size_t alignment) {
+        StreamAllocation a;
+        size_t start = alignUp(offset, alignment);
+        if (start + size > regionSize) {
+            if (overflows++ == 0)
+                std::cout << "ERROR::STREAM_BUFFER::REGION_FULL: " << regionSize / 1024 << " KB por frame no alcanzan" << std::endl;
+            return a;
+        }
+        offset = start + size;
+        a.offset = (GLintptr)(region * regionSize + start);
+        a.size = (GLsizeiptr)size;
+        a.data = persistent ? mapped + a.offset : shadow.data() + start;
+        return a;
+    }
+
+    StreamAllocation allocateUniform(size_t size) { return allocate(size, uniformAlignment); }
+    StreamAllocation allocateStorage(size_t size) { return allocate(size, storageAlignment); }
+    StreamAllocation allocateVertices(size_t size) { return allocate(size, 16); }
+
+    // Copia un struct (std140) y lo deja listo para glBindBufferRange
+    template <typename T>
+    StreamAllocation pushUniform(const T& value) {
+        StreamAllocation a = allocateUniform(sizeof(T));
+        if (a)
+            std::memcpy(a.data, &value, sizeof(T));
+        return a;
+    }
+
+    // Sin mapeo persistente, sube lo escrito desde el último commit. Hay que llamarlo antes
+    // de un draw que lea datos recién escritos; con mapeo coherente no hace nada.
+    void commit() {
+        if (persistent || committed == offset)
+            return;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.id());
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(region * regionSize + committed),
+                        (GLsizeiptr)(offset - committed), shadow.data() + committed);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        committed = offset;
+    }
+
+    void bindUniform(GLuint binding, const StreamAllocation& a) {
+        commit();
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer.id(), a.offset, a.size);
+    }
+
+    void bindStorage(GLuint binding, const StreamAllocation& a) {
+        commit();
+        if (glExt.shaderStorage)
+            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, buffer.id(), a.offset, a.size);
+    }
+
+    // Para datos de vértices: bindear buffer() en GL_ARRAY_BUFFER y usar a.offset en
+    // glVertexAttribPointer (llamar commit() antes del draw)
+    GLuint id() const { return buffer.id(); }
+    bool isPersistent() const { return persistent; }
+
+    uint64_t stallCount() const { return stalls; }
+    uint64_t overflowCount() const { return overflows; }
+
+    void report() const {
+        std::printf("StreamBuffer (%s, %u x %zu KB): %llu frames, pico %zu KB/frame, %llu stalls (%.2f ms), %llu desbordes\n",
+                    persistent ? "mapeo persistente" : "glBufferSubData", REGIONS, regionSize / 1024,
+                    (unsigned long long)frames, peakBytes / 1024, (unsigned long long)stalls, stallSeconds * 1000.0,
+                    (unsigned long long)overflows);
+    }
+
+private:
+    GpuBuffer buffer;
+    unsigned char* mapped = nullptr;    // Todo el búfer (mapeo persistente)
+    std::vector<unsigned char> shadow;  // Una región (sin mapeo persistente)
+    bool persistent = false;
+
+    size_t regionSize = 0;
+    size_t uniformAlignment = 256;
+    size_t storageAlignment = 16;
+    GLsync fences[REGIONS] = {};
+    unsigned int region = REGIONS - 1; // El primer beginFrame() pasa a la región 0
+    size_t offset = 0;
+    size_t committed = 0;
+
+    uint64_t frames = 0, stalls = 0, overflows = 0;
+    double stallSeconds = 0.0;
+    size_t peakBytes = 0;
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+};
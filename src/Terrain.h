@@ -0,0 +1,447 @@
+#pragma once
+
+// Terreno por mapa de alturas, partido en chunks que se cargan alrededor del jugador.
+//
+// Alturas: una rejilla con la resolución del LOD 0 sobre todo el terreno, leída de
+// un PNG en escala de grises (se remuestrea a la rejilla) o, si no existe, generada con
+// ruido fBm y aplanada en la arena del centro. height(x, z) es una interpolación bilineal
+// sobre esa rejilla: O(1) y de sólo lectura, se puede llamar desde cualquier hilo.
+//
+// Streaming: hay TERRAIN_MAX_CHUNKS slots fijos. update() pide los chunks que faltan dentro
+// de streamRadius (los más cercanos primero, con un límite por frame) y cada uno se arma en
+// un worker: alturas con 1 texel de margen (para las normales), altura mínima/máxima y un
+// oclusor conservador. Los que quedan lejos se retiran, pero el slot no se reutiliza hasta
+// que el render pasó el frame en que se retiró (el render lee las alturas del slot para
+// subirlas). Nada de esto asigna memoria después de init().
+//
+// LOD continuo (CDLOD): cada chunk visible elige LOD por su distancia a la cámara (cada
+// nivel dobla el rango del anterior) y el vertex shader mueve los vértices impares hacia la
+// malla del LOD siguiente al acercarse al límite, según la distancia de cada vértice. Como
+// dos chunks vecinos calculan lo mismo en el borde compartido, no hay grietas mientras
+// lod0Range sea mayor que la diagonal de un chunk / 0.7 (se corrige en init()).
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "OcclusionCulling.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+static const int TERRAIN_CHUNK_QUADS = 32;                        // Quads por lado en el LOD 0
+static const int TERRAIN_HEIGHT_SIZE = TERRAIN_CHUNK_QUADS + 3;   // Vértices + 1 texel de margen por lado
+static const int TERRAIN_LOD_COUNT = 4;
+static const int TERRAIN_MAX_CHUNKS = 256;
+static const int TERRAIN_OCCLUDER_QUADS = 4;                      // Oclusor: 4x4 quads por chunk
+
+struct TerrainSettings {
+    float size = 512.0f;         // Lado del terreno, centrado en el origen
+    float chunkSize = 16.0f;
+    float heightScale = 14.0f;   // Altura máxima (el PNG blanco o el ruido en 1)
+    float flatRadius = 30.0f;    // Arena plana alrededor del origen (sólo el ruido)
+    float streamRadius = 112.0f;  // Un poco más que el plano lejano de la cámara (100)
+    float lod0Range = 40.0f;     // Cada LOD dobla el rango del anterior
+    int maxLoadsPerFrame = 8;
+};
+
+// Un chunk para dibujar (lo llena la simulación en el snapshot)
+struct TerrainDraw {
+    uint32_t slot;
+    uint32_t serial;      // Cambia cada vez que el slot recibe otro chunk: el render vuelve a subir
+    glm::vec2 origin;     // Esquina mínima en x/z
+    int lod;
+    glm::vec2 morphRange; // Distancia donde empieza y termina la transición al LOD siguiente
+};
+
+class Terrain {
+public:
+    // Hilo principal, antes de la simulación
+    bool init(const TerrainSettings& newSettings, const char* heightmapPath, JobSystem* jobs) {
+        settings = newSettings;
+        chunksPerSide = std::max(1, (int)std::lround(settings.size / settings.chunkSize));
+        settings.size = chunksPerSide * settings.chunkSize;
+        spacing = settings.chunkSize / TERRAIN_CHUNK_QUADS;
+        samples = chunksPerSide * TERRAIN_CHUNK_QUADS + 1;
+        heights.assign((size_t)samples * samples, 0.0f);
+
+        int width = 0, height = 0, components = 0;
+        stbi_us* pixels = stbi_load_16(heightmapPath, &width, &height, &components, 1);
+        if (pixels) {
+            loadHeightmap(pixels, width, height, jobs);
+            stbi_image_free(pixels);
+            std::printf("Terreno: %s (%dx%d) en %dx%d muestras\n", heightmapPath, width, height, samples, samples);
+        } else {
+            generateNoise(jobs);
+            std::printf("Terreno: sin %s, ruido procedural en %dx%d muestras\n", heightmapPath, samples, samples);
+        }
+
+        // Sin grietas entre LODs: el rango tiene que cubrir la diagonal del chunk (ver arriba)
+        float diagonal = std::sqrt(2.0f * settings.chunkSize * settings.chunkSize + settings.heightScale * settings.heightScale);
+        settings.lod0Range = std::max(settings.lod0Range, diagonal / 0.7f);
+
+        chunks.reset(new Chunk[TERRAIN_MAX_CHUNKS]);
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++) {
+            chunks[i].heights.resize((size_t)TERRAIN_HEIGHT_SIZE * TERRAIN_HEIGHT_SIZE);
+            chunks[i].occluder.vertices.resize((TERRAIN_OCCLUDER_QUADS + 1) * (TERRAIN_OCCLUDER_QUADS + 1));
+            buildOccluderIndices(chunks[i].occluder);
+        }
+        slotOf.assign((size_t)chunksPerSide * chunksPerSide, -1);
+        candidates.reserve(slotOf.size());
+        return pixels != nullptr;
+    }
+
+    // Altura del suelo en (x, z); fuera del terreno, la del borde
+    float height(float x, float z) const {
+        float gx = std::min(std::max((x + 0.5f * settings.size) / spacing, 0.0f), (float)(samples - 1));
+        float gz = std::min(std::max((z + 0.5f * settings.size) / spacing, 0.0f), (float)(samples - 1));
+        int x0 = std::min((int)gx, samples - 2), z0 = std::min((int)gz, samples - 2);
+        float fx = gx - x0, fz = gz - z0;
+        const float* row0 = &heights[(size_t)z0 * samples + x0];
+        const float* row1 = row0 + samples;
+        float top = row0[0] + (row0[1] - row0[0]) * fx;
+        float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+        return top + (bottom - top) * fz;
+    }
+
+    // Carga sin límite por frame y espera (pantalla de carga): el primer frame ya tiene suelo
+    void preload(const glm::vec3& focus, JobSystem* jobs) {
+        int limit = settings.maxLoadsPerFrame;
+        settings.maxLoadsPerFrame = TERRAIN_MAX_CHUNKS;
+        update(focus, 0, 0, jobs);
+        settings.maxLoadsPerFrame = limit;
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++)
+            while (chunks[i].state.load(std::memory_order_acquire) == CHUNK_LOADING)
+                std::this_thread::yield();
+        update(focus, 0, 0, jobs);
+    }
+
+    // Cuadro del mapa de sombras en x/z (antes de update()): sólo los chunks que lo tocan
+    // cambian version() y entran en la lista de sombras de buildDraws()
+    void setShadowBox(const glm::vec3& center, float halfExtent) {
+        shadowCenter = glm::vec2(center.x, center.z);
+        shadowHalfExtent = halfExtent;
+    }
+
+    // Una vez por tick (hilo de la simulación). renderedFrame: último frame que tomó el render.
+    void update(const glm::vec3& focus, uint64_t frame, uint64_t renderedFrame, JobSystem* jobs) {
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++) {
+            Chunk& chunk = chunks[i];
+            int state = chunk.state.load(std::memory_order_acquire);
+            if (state == CHUNK_LOADED) {
+                chunk.state.store(CHUNK_RESIDENT, std::memory_order_relaxed);
+                if (inShadowBox(chunk))
+                    shadowVersion++;
+                loadsCompleted++;
+            } else if (state == CHUNK_RETIRED && renderedFrame > chunk.retiredFrame) {
+                chunk.state.store(CHUNK_FREE, std::memory_order_relaxed);
+            }
+        }
+
+        // Fuera del radio (con margen de un chunk para no cargar y descargar en el borde)
+        float evictRadius = settings.streamRadius + settings.chunkSize;
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++) {
+            Chunk& chunk = chunks[i];
+            if (chunk.state.load(std::memory_order_relaxed) != CHUNK_RESIDENT || distanceTo(chunk.cx, chunk.cz, focus) <= evictRadius)
+                continue;
+            chunk.state.store(CHUNK_RETIRED, std::memory_order_relaxed);
+            chunk.retiredFrame = frame;
+            slotOf[(size_t)chunk.cz * chunksPerSide + chunk.cx] = -1;
+            if (inShadowBox(chunk))
+                shadowVersion++;
+            evictions++;
+        }
+
+        // Los que faltan, de más cerca a más lejos
+        candidates.clear();
+        int reach = (int)std::ceil(settings.streamRadius / settings.chunkSize) + 1;
+        int fx = (int)std::floor((focus.x + 0.5f * settings.size) / settings.chunkSize);
+        int fz = (int)std::floor((focus.z + 0.5f * settings.size) / settings.chunkSize);
+        for (int cz = std::max(0, fz - reach); cz <= std::min(chunksPerSide - 1, fz + reach); cz++) {
+            for (int cx = std::max(0, fx - reach); cx <= std::min(chunksPerSide - 1, fx + reach); cx++) {
+                float d = distanceTo(cx, cz, focus);
+                if (d <= settings.streamRadius && slotOf[(size_t)cz * chunksPerSide + cx] < 0)
+                    candidates.push_back(Candidate{ d, cx, cz });
+            }
+        }
+        size_t wanted = std::min(candidates.size(), (size_t)settings.maxLoadsPerFrame);
+        std::partial_sort(candidates.begin(), candidates.begin() + wanted, candidates.end(),
+                          [](const Candidate& a, const Candidate& b) { return a.distance < b.distance; });
+
+        int freeSlot = 0;
+        for (size_t c = 0; c < wanted; c++) {
+            while (freeSlot < TERRAIN_MAX_CHUNKS && chunks[freeSlot].state.load(std::memory_order_relaxed) != CHUNK_FREE)
+                freeSlot++;
+            if (freeSlot == TERRAIN_MAX_CHUNKS) {
+                slotShortages++;
+                break;
+            }
+            Chunk& chunk = chunks[freeSlot];
+            chunk.cx = candidates[c].cx;
+            chunk.cz = candidates[c].cz;
+            chunk.serial = ++serialCounter;
+            chunk.state.store(CHUNK_LOADING, std::memory_order_relaxed);
+            slotOf[(size_t)chunk.cz * chunksPerSide + chunk.cx] = (int16_t)freeSlot;
+            loadsStarted++;
+
+            int slot = freeSlot;
+            if (!jobs || jobs->singleThreaded()) {
+                buildChunk(slot);
+            } else {
+                jobs->run(jobs->create([this, slot] { buildChunk(slot); }));
+            }
+        }
+    }
+
+    // Listas del snapshot: los chunks visibles con su LOD y los que caen en el cuadro de las
+    // sombras (siempre LOD 0, sin transición: el mapa estático no depende de la cámara)
+    void buildDraws(const glm::vec3& cameraPos, const Frustum& frustum,
+                    std::vector<TerrainDraw>& visible, std::vector<TerrainDraw>& shadowCasters) const {
+        visible.clear();
+        shadowCasters.clear();
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++) {
+            const Chunk& chunk = chunks[i];
+            if (chunk.state.load(std::memory_order_relaxed) != CHUNK_RESIDENT)
+                continue;
+            glm::vec3 boundsMin, boundsMax;
+            bounds(chunk, boundsMin, boundsMax);
+            TerrainDraw draw;
+            draw.slot = (uint32_t)i;
+            draw.serial = chunk.serial;
+            draw.origin = glm::vec2(boundsMin.x, boundsMin.z);
+            draw.lod = 0;
+            draw.morphRange = glm::vec2(1e9f, 2e9f);
+            if (inShadowBox(chunk))
+                shadowCasters.push_back(draw);
+
+            glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+            if (!frustum.intersectsSphere(center, glm::length(boundsMax - center)))
+                continue;
+            float distance = glm::length(glm::max(glm::max(boundsMin - cameraPos, cameraPos - boundsMax), glm::vec3(0.0f)));
+            float range = settings.lod0Range, previous = 0.0f;
+            int lod = 0;
+            while (lod < TERRAIN_LOD_COUNT - 1 && distance >= range) {
+                previous = range;
+                range *= 2.0f;
+                lod++;
+            }
+            draw.lod = lod;
+            if (lod < TERRAIN_LOD_COUNT - 1)
+                draw.morphRange = glm::vec2(range - 0.3f * (range - previous), range);
+            visible.push_back(draw);
+            lodCounts[lod]++;
+        }
+        drawFrames++;
+    }
+
+    // Oclusores de los chunks cercanos y en pantalla para el OcclusionBuffer
+    void addOccluders(OcclusionBuffer& occlusion, const Frustum& frustum, const glm::vec3& cameraPos, float maxDistance) const {
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++) {
+            const Chunk& chunk = chunks[i];
+            if (chunk.state.load(std::memory_order_relaxed) != CHUNK_RESIDENT)
+                continue;
+            glm::vec3 boundsMin, boundsMax;
+            bounds(chunk, boundsMin, boundsMax);
+            glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+            if (glm::length(center - cameraPos) > maxDistance || !frustum.intersectsSphere(center, glm::length(boundsMax - center)))
+                continue;
+            occlusion.addOccluder(chunk.occluder, glm::translate(glm::mat4(1.0f), glm::vec3(boundsMin.x, 0.0f, boundsMin.z)));
+        }
+    }
+
+    // Alturas del slot (TERRAIN_HEIGHT_SIZE^2). Sólo para el render, con un slot de su snapshot.
+    const float* chunkHeights(uint32_t slot) const { return chunks[slot].heights.data(); }
+    float chunkSize() const { return settings.chunkSize; }
+    // Caja del chunk de un slot residente (hilo de la simulación)
+    void chunkBounds(uint32_t slot, glm::vec3& boundsMin, glm::vec3& boundsMax) const { bounds(chunks[slot], boundsMin, boundsMax); }
+    // Cambia cuando entra o sale un chunk del cuadro de las sombras (invalida el mapa estático)
+    uint32_t version() const { return shadowVersion; }
+
+    void report() const {
+        int resident = 0;
+        for (int i = 0; i < TERRAIN_MAX_CHUNKS; i++)
+            resident += chunks[i].state.load(std::memory_order_relaxed) == CHUNK_RESIDENT;
+        std::printf("Terreno: %d chunks residentes de %d slots | %llu cargas (%llu terminadas), %llu descargas, %llu sin slot\n",
+                    resident, TERRAIN_MAX_CHUNKS, (unsigned long long)loadsStarted, (unsigned long long)loadsCompleted,
+                    (unsigned long long)evictions, (unsigned long long)slotShortages);
+        if (drawFrames > 0)
+            std::printf("  Chunks visibles por frame: LOD0 %.1f, LOD1 %.1f, LOD2 %.1f, LOD3 %.1f\n",
+                        (double)lodCounts[0] / drawFrames, (double)lodCounts[1] / drawFrames,
+                        (double)lodCounts[2] / drawFrames, (double)lodCounts[3] / drawFrames);
+    }
+
+private:
+    enum ChunkState : int { CHUNK_FREE, CHUNK_LOADING, CHUNK_LOADED, CHUNK_RESIDENT, CHUNK_RETIRED };
+
+    struct Chunk {
+        std::atomic<int> state{CHUNK_FREE};
+        int cx = 0, cz = 0;
+        uint32_t serial = 0;
+        uint64_t retiredFrame = 0;
+        float minHeight = 0.0f, maxHeight = 0.0f;
+        std::vector<float> heights;
+        OccluderMesh occluder;  // En coordenadas del chunk (origen en su esquina mínima)
+    };
+
+    struct Candidate {
+        float distance;
+        int cx, cz;
+    };
+
+    TerrainSettings settings;
+    int chunksPerSide = 0, samples = 0;
+    float spacing = 1.0f;
+    std::vector<float> heights;
+    std::unique_ptr<Chunk[]> chunks;
+    std::vector<int16_t> slotOf;        // Slot de cada chunk del terreno (-1 si no está)
+    std::vector<Candidate> candidates;
+    uint32_t serialCounter = 0, shadowVersion = 0;
+    glm::vec2 shadowCenter = glm::vec2(0.0f);
+    float shadowHalfExtent = 0.0f;
+    uint64_t loadsStarted = 0, loadsCompleted = 0, evictions = 0, slotShortages = 0;
+    mutable uint64_t lodCounts[TERRAIN_LOD_COUNT] = {}, drawFrames = 0;
+
+    float distanceTo(int cx, int cz, const glm::vec3& focus) const {
+        float x = -0.5f * settings.size + (cx + 0.5f) * settings.chunkSize;
+        float z = -0.5f * settings.size + (cz + 0.5f) * settings.chunkSize;
+        return std::sqrt((x - focus.x) * (x - focus.x) + (z - focus.z) * (z - focus.z));
+    }
+
+    void bounds(const Chunk& chunk, glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+        boundsMin = glm::vec3(-0.5f * settings.size + chunk.cx * settings.chunkSize, chunk.minHeight,
+                              -0.5f * settings.size + chunk.cz * settings.chunkSize);
+        boundsMax = boundsMin + glm::vec3(settings.chunkSize, 0.0f, settings.chunkSize);
+        boundsMax.y = chunk.maxHeight;
+    }
+
+    bool inShadowBox(const Chunk& chunk) const {
+        glm::vec3 boundsMin, boundsMax;
+        bounds(chunk, boundsMin, boundsMax);
+        return boundsMax.x > shadowCenter.x - shadowHalfExtent && boundsMin.x < shadowCenter.x + shadowHalfExtent &&
+               boundsMax.z > shadowCenter.y - shadowHalfExtent && boundsMin.z < shadowCenter.y + shadowHalfExtent;
+    }
+
+    float sample(int x, int z) const {
+        x = std::min(std::max(x, 0), samples - 1);
+        z = std::min(std::max(z, 0), samples - 1);
+        return heights[(size_t)z * samples + x];
+    }
+
+    // En un worker: sólo escribe en su slot, que está en CHUNK_LOADING hasta que termina
+    void buildChunk(int slot) {
+        Chunk& chunk = chunks[slot];
+        int baseX = chunk.cx * TERRAIN_CHUNK_QUADS, baseZ = chunk.cz * TERRAIN_CHUNK_QUADS;
+        float lowest = 1e30f, highest = -1e30f;
+        for (int z = 0; z < TERRAIN_HEIGHT_SIZE; z++) {
+            for (int x = 0; x < TERRAIN_HEIGHT_SIZE; x++) {
+                float h = sample(baseX + x - 1, baseZ + z - 1);
+                chunk.heights[(size_t)z * TERRAIN_HEIGHT_SIZE + x] = h;
+                if (x >= 1 && z >= 1 && x <= TERRAIN_CHUNK_QUADS + 1 && z <= TERRAIN_CHUNK_QUADS + 1) {
+                    lowest = std::min(lowest, h);
+                    highest = std::max(highest, h);
+                }
+            }
+        }
+        chunk.minHeight = lowest;
+        chunk.maxHeight = highest;
+
+        // Oclusor conservador: cada vértice toma la altura mínima de los quads que lo tocan,
+        // así el triángulo queda siempre por debajo del suelo real y no tapa de más
+        const int step = TERRAIN_CHUNK_QUADS / TERRAIN_OCCLUDER_QUADS;
+        for (int oz = 0; oz <= TERRAIN_OCCLUDER_QUADS; oz++) {
+            for (int ox = 0; ox <= TERRAIN_OCCLUDER_QUADS; ox++) {
+                float h = 1e30f;
+                for (int z = std::max(0, (oz - 1) * step); z <= std::min(TERRAIN_CHUNK_QUADS, (oz + 1) * step); z++)
+                    for (int x = std::max(0, (ox - 1) * step); x <= std::min(TERRAIN_CHUNK_QUADS, (ox + 1) * step); x++)
+                        h = std::min(h, chunk.heights[(size_t)(z + 1) * TERRAIN_HEIGHT_SIZE + x + 1]);
+                chunk.occluder.vertices[oz * (TERRAIN_OCCLUDER_QUADS + 1) + ox] =
+                    glm::vec3(ox * step * spacing, h, oz * step * spacing);
+            }
+        }
+        chunk.state.store(CHUNK_LOADED, std::memory_order_release);
+    }
+
+    // Misma orientación que la cara de arriba de OccluderMesh::box
+    static void buildOccluderIndices(OccluderMesh& mesh) {
+        const uint32_t row = TERRAIN_OCCLUDER_QUADS + 1;
+        mesh.indices.clear();
+        for (uint32_t z = 0; z < TERRAIN_OCCLUDER_QUADS; z++) {
+            for (uint32_t x = 0; x < TERRAIN_OCCLUDER_QUADS; x++) {
+                uint32_t a = z * row + x, b = (z + 1) * row + x, c = b + 1, d = a + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, b, c, a, c, d });
+            }
+        }
+    }
+
+    void loadHeightmap(const stbi_us* pixels, int width, int height, JobSystem* jobs) {
+        auto rows = [&](size_t begin, size_t end) {
+            for (size_t z = begin; z < end; z++) {
+                float v = (float)z / (samples - 1) * (height - 1);
+                int y0 = std::min((int)v, height - 1), y1 = std::min(y0 + 1, height - 1);
+                float fy = v - y0;
+                for (int x = 0; x < samples; x++) {
+                    float u = (float)x / (samples - 1) * (width - 1);
+                    int x0 = std::min((int)u, width - 1), x1 = std::min(x0 + 1, width - 1);
+                    float fx = u - x0;
+                    float top = pixels[y0 * width + x0] + (pixels[y0 * width + x1] - (float)pixels[y0 * width + x0]) * fx;
+                    float bottom = pixels[y1 * width + x0] + (pixels[y1 * width + x1] - (float)pixels[y1 * width + x0]) * fx;
+                    heights[z * samples + x] = (top + (bottom - top) * fy) / 65535.0f * settings.heightScale;
+                }
+            }
+        };
+        if (jobs)
+            jobs->parallel_for((size_t)samples, 32, rows);
+        else
+            rows(0, (size_t)samples);
+    }
+
+    // fBm de ruido de valor (5 octavas); la arena del centro queda plana y sube hacia afuera
+    void generateNoise(JobSystem* jobs) {
+        auto rows = [&](size_t begin, size_t end) {
+            for (size_t z = begin; z < end; z++) {
+                for (int x = 0; x < samples; x++) {
+                    float wx = -0.5f * settings.size + x * spacing, wz = -0.5f * settings.size + z * spacing;
+                    float amplitude = 0.5f, frequency = 1.0f / 64.0f, value = 0.0f;
+                    for (int octave = 0; octave < 5; octave++) {
+                        value += amplitude * valueNoise(wx * frequency, wz * frequency, octave);
+                        amplitude *= 0.5f;
+                        frequency *= 2.0f;
+                    }
+                    float r = std::sqrt(wx * wx + wz * wz);
+                    float t = std::min(std::max((r - settings.flatRadius) / settings.flatRadius, 0.0f), 1.0f);
+                    heights[z * samples + x] = value * settings.heightScale * t * t * (3.0f - 2.0f * t);
+                }
+            }
+        };
+        if (jobs)
+            jobs->parallel_for((size_t)samples, 32, rows);
+        else
+            rows(0, (size_t)samples);
+    }
+
+    static float lattice(int x, int z, int seed) {
+        uint32_t h = (uint32_t)x * 374761393u + (uint32_t)z * 668265263u + (uint32_t)seed * 2246822519u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        return (float)((h ^ (h >> 16)) & 0xFFFFFF) / (float)0xFFFFFF;
+    }
+
+    static float valueNoise(float x, float z, int seed) {
+        float fx = std::floor(x), fz = std::floor(z);
+        int ix = (int)fx, iz = (int)fz;
+        float tx = x - fx, tz = z - fz;
+        tx = tx * tx * (3.0f - 2.0f * tx);
+        tz = tz * tz * (3.0f - 2.0f * tz);
+        float a = lattice(ix, iz, seed), b = lattice(ix + 1, iz, seed);
+        float c = lattice(ix, iz + 1, seed), d = lattice(ix + 1, iz + 1, seed);
+        return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * tz;
+    }
+};
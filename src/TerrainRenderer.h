@@ -0,0 +1,137 @@
+#pragma once
+
+// Dibuja los chunks de Terrain.h (hilo de render).
+//
+// Una malla de rejilla por LOD compartida por todos los chunks (sólo coordenadas de la
+// rejilla; la altura sale de la textura del chunk en terrain.vert) y una textura R32F de
+// alturas por slot. La textura se vuelve a subir sólo cuando el slot trae otro chunk (cambia
+// su serial), así que en estado estable cada chunk cuesta un draw y unos uniforms.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GpuResources.h"
+#include "Shader.h"
+#include "Terrain.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Unidad de textura de las alturas (0 difusa, 1-2 VAT, 3-5 luces, 6 sombras)
+static const int TERRAIN_HEIGHT_UNIT = 7;
+
+class TerrainRenderer {
+public:
+    // Hilo con el contexto
+    void init() {
+        for (int lod = 0; lod < TERRAIN_LOD_COUNT; lod++)
+            buildGrid(lod);
+    }
+
+    // Una vez por shader de terreno
+    static void bindSampler(Shader& shader) {
+        shader.use();
+        shader.setInt("heightMap", TERRAIN_HEIGHT_UNIT);
+    }
+
+    // 'shader' ya en uso, con los bloques del frame y del objeto enlazados
+    void draw(Shader& shader, const Terrain& terrain, const TerrainDraw* draws, size_t count) {
+        shader.setFloat("chunkSize", terrain.chunkSize());
+        glActiveTexture(GL_TEXTURE0 + TERRAIN_HEIGHT_UNIT);
+        for (size_t i = 0; i < count; i++) {
+            const TerrainDraw& draw = draws[i];
+            upload(terrain, draw);
+            glBindTexture(GL_TEXTURE_2D, heights[draw.slot].id());
+            const Grid& grid = grids[draw.lod];
+            shader.setVec2("chunkOrigin", draw.origin);
+            shader.setFloat("gridDim", (float)grid.quads);
+            shader.setVec2("morphRange", draw.morphRange);
+            glBindVertexArray(grid.VAO.id());
+            glDrawElements(GL_TRIANGLES, grid.indexCount, GL_UNSIGNED_INT, 0);
+            drawCalls++;
+        }
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void report() const {
+        std::printf("Terreno (render): %llu draws, %llu subidas de chunk\n",
+                    (unsigned long long)drawCalls, (unsigned long long)uploads);
+    }
+
+private:
+    struct Grid {
+        GpuVertexArray VAO;
+        GpuBuffer vertexBuffer, indexBuffer;
+        GLsizei indexCount = 0;
+        int quads = 0;
+    };
+
+    Grid grids[TERRAIN_LOD_COUNT];
+    GpuTexture heights[TERRAIN_MAX_CHUNKS];
+    uint32_t uploadedSerial[TERRAIN_MAX_CHUNKS] = {};
+    uint64_t drawCalls = 0, uploads = 0;
+
+    void upload(const Terrain& terrain, const TerrainDraw& draw) {
+        if (uploadedSerial[draw.slot] == draw.serial)
+            return;
+        GpuTexture& texture = heights[draw.slot];
+        bool created = !texture;
+        if (created)
+            texture = GpuTexture::generate();
+        glBindTexture(GL_TEXTURE_2D, texture.id());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (created) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, TERRAIN_HEIGHT_SIZE, TERRAIN_HEIGHT_SIZE, 0, GL_RED, GL_FLOAT,
+                         terrain.chunkHeights(draw.slot));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TERRAIN_HEIGHT_SIZE, TERRAIN_HEIGHT_SIZE, GL_RED, GL_FLOAT,
+                            terrain.chunkHeights(draw.slot));
+        }
+        uploadedSerial[draw.slot] = draw.serial;
+        uploads++;
+    }
+
+    // (quads + 1)^2 vértices con su coordenada entera en la rejilla del LOD
+    void buildGrid(int lod) {
+        Grid& grid = grids[lod];
+        grid.quads = TERRAIN_CHUNK_QUADS >> lod;
+        int row = grid.quads + 1;
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        vertices.reserve((size_t)row * row * 2);
+        indices.reserve((size_t)grid.quads * grid.quads * 6);
+        for (int z = 0; z < row; z++) {
+            for (int x = 0; x < row; x++) {
+                vertices.push_back((float)x);
+                vertices.push_back((float)z);
+            }
+        }
+        // CCW visto desde arriba (normal hacia +y), como la cara de arriba de OccluderMesh::box
+        for (int z = 0; z < grid.quads; z++) {
+            for (int x = 0; x < grid.quads; x++) {
+                uint32_t a = z * row + x, b = (z + 1) * row + x, c = b + 1, d = a + 1;
+                indices.insert(indices.end(), { a, b, c, a, c, d });
+            }
+        }
+        grid.indexCount = (GLsizei)indices.size();
+
+        grid.VAO = GpuVertexArray::generate();
+        grid.vertexBuffer = GpuBuffer::generate();
+        grid.indexBuffer = GpuBuffer::generate();
+        glBindVertexArray(grid.VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, grid.vertexBuffer.id());
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, grid.indexBuffer.id());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glBindVertexArray(0);
+    }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Triple buffer sin locks para pasar datos de un productor a un consumidor.
+// El productor siempre escribe en su propio slot (back) y al publicar lo intercambia
+// atómicamente con el slot del medio; el consumidor toma el del medio sólo si hay uno nuevo.
+// Ninguno de los dos espera al otro: el productor puede sobrescribir un dato que nadie leyó.
+template <typename T>
+class TripleBuffer {
+public:
+    // --- Productor ---
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(backIndex | FRESH), std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // --- Consumidor ---
+    // Devuelve true si había un dato nuevo; en ambos casos front() es el más reciente visto
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static constexpr uint8_t FRESH = 0x80;
+    static constexpr uint8_t INDEX_MASK = 0x03;
+
+    T slots[3];
+    alignas(64) uint8_t backIndex = 0;   // Sólo productor
+    alignas(64) uint8_t frontIndex = 2;  // Sólo consumidor
+    alignas(64) std::atomic<uint8_t> middle{1};
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// Bloques de uniforms (std140) que comparten los shaders y el código que los llena.
+// En std140 un vec3 ocupa lo mismo que un vec4, así que aquí se usan vec4 para que el
+// struct de C++ tenga exactamente la misma forma que el bloque de GLSL.
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Puntos de enlace (glUniformBlockBinding / glBindBufferRange)
+enum UniformBinding : GLuint {
+    UBO_FRAME  = 0,
+    UBO_OBJECT = 1
+};
+
+// "FrameData" en los shaders: una vez por frame
+struct FrameUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec4 viewPos;   // xyz = cámara
+    glm::vec4 clusterGrid;   // xyz = tiles en x, en y y rebanadas (LightClusters.h)
+    glm::vec4 clusterDepth;  // x = escala, y = sesgo de la rebanada: log(profundidad) * x + y
+    glm::mat4 lightSpace;    // Mundo -> mapa de sombras (ShadowMap.h)
+};
+
+// "ObjectData" en los shaders: una vez por draw
+struct ObjectUniforms {
+    glm::mat4 model;
+    glm::vec4 lightPos;  // xyz = dirección hacia la luz (sol)
+};
+
+static_assert(sizeof(FrameUniforms) == 240, "FrameUniforms no coincide con std140");
+static_assert(sizeof(ObjectUniforms) == 80, "ObjectUniforms no coincide con std140");
@@ -0,0 +1,144 @@
+#pragma once
+
+// Formato de archivo de las texturas de animación de vértices (VAT).
+//
+// tools/vat_bake.cpp evalúa offline las animaciones de un FBX (jerarquía + skinning) y guarda
+// la posición y la normal de cada vértice en cada frame. En tiempo de ejecución el vertex
+// shader las lee de dos texturas con el índice del vértice (gl_VertexID), así que animar
+// una multitud no cuesta nada de CPU por personaje.
+//
+// Los texels van en orden frame * vertexCount + vértice, en filas de VAT_TEXTURE_WIDTH:
+//   - posiciones: RGBA16 normalizado dentro de [boundsMin, boundsMax] (w sin usar)
+//   - normales:   RGBA8 con signo (w sin usar)
+// Las posiciones están en el espacio del nodo raíz del archivo (ya incluyen las
+// transformaciones de los aiNode), igual que lo que dibuja Model con parent = identidad.
+//
+// Sólo CPU, sin OpenGL: lo usan la herramienta de bake y el cargador del juego.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+
+static const uint32_t VAT_MAGIC = 0x31544156; // "VAT1"
+static const uint32_t VAT_VERSION = 1;
+static const uint32_t VAT_TEXTURE_WIDTH = 2048;
+
+struct VatHeader {
+    uint32_t magic = VAT_MAGIC;
+    uint32_t version = VAT_VERSION;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t frameCount = 0;    // Todos los clips juntos
+    uint32_t clipCount = 0;
+    uint32_t submeshCount = 0;
+    uint32_t textureWidth = VAT_TEXTURE_WIDTH;
+    uint32_t textureHeight = 0;
+    float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+    float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+// Una animación del archivo: frames [firstFrame, firstFrame + frameCount) que se repiten
+struct VatClip {
+    char name[32] = {};
+    uint32_t firstFrame = 0;
+    uint32_t frameCount = 0;
+    float fps = 30.0f;
+};
+
+// Rango de índices que comparte material (una malla del archivo original)
+struct VatSubmesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    char diffuse[128] = {};   // Ruta de la textura tal como viene en el material
+};
+
+struct VatData {
+    VatHeader header;
+    std::vector<VatClip> clips;
+    std::vector<VatSubmesh> submeshes;
+    std::vector<float> texCoords;      // 2 por vértice
+    std::vector<uint32_t> indices;
+    std::vector<uint16_t> positions;   // 4 por texel
+    std::vector<int8_t> normals;       // 4 por texel
+
+    size_t texelCount() const { return (size_t)header.textureWidth * header.textureHeight; }
+
+    size_t bytes() const {
+        return texCoords.size() * sizeof(float) + indices.size() * sizeof(uint32_t)
+             + positions.size() * sizeof(uint16_t) + normals.size() * sizeof(int8_t);
+    }
+};
+
+// Filas de textura necesarias para 'frames' frames de 'vertices' vértices
+inline uint32_t vatTextureHeight(uint32_t vertices, uint32_t frames, uint32_t width = VAT_TEXTURE_WIDTH) {
+    uint64_t texels = (uint64_t)vertices * frames;
+    return (uint32_t)((texels + width - 1) / width);
+}
+
+inline bool writeVatFile(const std::string& path, const VatData& data) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::VAT::FILE_NOT_WRITTEN: " << path << std::endl;
+        return false;
+    }
+    const VatHeader& h = data.header;
+    bool ok = std::fwrite(&h, sizeof(h), 1, file) == 1;
+    ok = ok && std::fwrite(data.clips.data(), sizeof(VatClip), h.clipCount, file) == h.clipCount;
+    ok = ok && std::fwrite(data.submeshes.data(), sizeof(VatSubmesh), h.submeshCount, file) == h.submeshCount;
+    ok = ok && std::fwrite(data.texCoords.data(), sizeof(float), data.texCoords.size(), file) == data.texCoords.size();
+    ok = ok && std::fwrite(data.indices.data(), sizeof(uint32_t), data.indices.size(), file) == data.indices.size();
+    ok = ok && std::fwrite(data.positions.data(), sizeof(uint16_t), data.positions.size(), file) == data.positions.size();
+    ok = ok && std::fwrite(data.normals.data(), sizeof(int8_t), data.normals.size(), file) == data.normals.size();
+    std::fclose(file);
+    if (!ok)
+        std::cout << "ERROR::VAT::FILE_NOT_WRITTEN: " << path << std::endl;
+    return ok;
+}
+
+// Sólo CPU: se puede llamar desde un worker
+inline bool readVatFile(const std::string& path, VatData& data) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "ERROR::VAT::FILE_NOT_SUCCESSFULLY_READ: " << path << " (generarlo con vat_bake)" << std::endl;
+        return false;
+    }
+    VatHeader& h = data.header;
+    bool ok = std::fread(&h, sizeof(h), 1, file) == 1 && h.magic == VAT_MAGIC && h.version == VAT_VERSION
+           && h.textureWidth > 0 && (uint64_t)h.textureWidth * h.textureHeight >= (uint64_t)h.vertexCount * h.frameCount;
+    if (ok) {
+        data.clips.resize(h.clipCount);
+        data.submeshes.resize(h.submeshCount);
+        data.texCoords.resize((size_t)h.vertexCount * 2);
+        data.indices.resize(h.indexCount);
+        data.positions.resize(data.texelCount() * 4);
+        data.normals.resize(data.texelCount() * 4);
+        ok = std::fread(data.clips.data(), sizeof(VatClip), h.clipCount, file) == h.clipCount
+          && std::fread(data.submeshes.data(), sizeof(VatSubmesh), h.submeshCount, file) == h.submeshCount
+          && std::fread(data.texCoords.data(), sizeof(float), data.texCoords.size(), file) == data.texCoords.size()
+          && std::fread(data.indices.data(), sizeof(uint32_t), data.indices.size(), file) == data.indices.size()
+          && std::fread(data.positions.data(), sizeof(uint16_t), data.positions.size(), file) == data.positions.size()
+          && std::fread(data.normals.data(), sizeof(int8_t), data.normals.size(), file) == data.normals.size();
+    }
+    std::fclose(file);
+    // El shader confía en estos rangos
+    for (size_t i = 0; ok && i < data.clips.size(); i++)
+        ok = data.clips[i].frameCount > 0 && data.clips[i].firstFrame + data.clips[i].frameCount <= h.frameCount;
+    for (size_t i = 0; ok && i < data.submeshes.size(); i++)
+        ok = data.submeshes[i].firstIndex + data.submeshes[i].indexCount <= h.indexCount;
+    for (size_t i = 0; ok && i < data.indices.size(); i++)
+        ok = data.indices[i] < h.vertexCount;
+    if (!ok) {
+        std::cout << "ERROR::VAT::INVALID_FILE: " << path << std::endl;
+        data = VatData();
+        return false;
+    }
+    // Las cadenas del archivo siempre terminan en cero
+    for (VatClip& clip : data.clips)
+        clip.name[sizeof(clip.name) - 1] = '\0';
+    for (VatSubmesh& submesh : data.submeshes)
+        submesh.diffuse[sizeof(submesh.diffuse) - 1] = '\0';
+    return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+// Multitudes animadas con texturas de animación de vértices (VAT).
+//
+// Carga un .vat horneado por tools/vat_bake y dibuja todas las instancias en un draw por
+// submalla con la variante SHADER_INSTANCED | SHADER_VERTEX_ANIMATION de basic.vert: la
+// animación avanza en la GPU con el tiempo global más el desfase de cada instancia, así que
+// la CPU no hace nada por personaje (ni huesos ni matrices nuevas). Las instancias visibles
+// del frame (después del culling) llegan en el StreamBuffer, como las de los proyectiles.
+//
+// Igual que Model, la carga va en dos fases: import() (archivo y texturas, cualquier hilo)
+// y upload() (hilo con el contexto).
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GpuResources.h"
+#include "Model.h"
+#include "Shader.h"
+#include "VatFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <iostream>
+
+// Datos por instancia (atributos 5..8 la matriz, 9 la animación)
+struct VatInstance {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec4 anim = glm::vec4(0.0f);  // primer frame, frames, fps, desfase en segundos
+};
+static_assert(sizeof(VatInstance) == 80, "VatInstance debe coincidir con los atributos 5..9");
+
+class VatCrowd {
+public:
+    VatCrowd() = default;
+    VatCrowd(const VatCrowd&) = delete;
+    VatCrowd& operator=(const VatCrowd&) = delete;
+
+    // Sólo CPU: lee el archivo y decodifica las texturas difusas
+    bool import(const std::string& path) {
+        if (!readVatFile(path, data))
+            return false;
+        std::string directory = path.substr(0, path.find_last_of('/'));
+        images.resize(data.submeshes.size());
+        for (size_t i = 0; i < data.submeshes.size(); i++)
+            if (data.submeshes[i].diffuse[0] != '\0')
+                images[i] = loadImageData(data.submeshes[i].diffuse, directory);
+        return true;
+    }
+
+    // Hilo con el contexto. Después de subir, la copia de CPU se libera (sólo quedan los clips)
+    bool upload() {
+        header = data.header;
+        const VatHeader& h = header;
+        if (h.vertexCount == 0)
+            return false;
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        if ((GLint)h.textureWidth > maxSize || (GLint)h.textureHeight > maxSize) {
+            std::cout << "ERROR::VAT::TEXTURE_TOO_LARGE: " << h.textureWidth << "x" << h.textureHeight
+                      << " (max " << maxSize << ")" << std::endl;
+            return false;
+        }
+
+        positions = createTexture(GL_RGBA16, GL_UNSIGNED_SHORT, data.positions.data());
+        normals = createTexture(GL_RGBA8_SNORM, GL_BYTE, data.normals.data());
+        for (ImageData& image : images)
+            diffuse.push_back(image.pixels ? uploadTexture(image) : GpuTexture());
+
+        // Sólo UVs e índices: la posición y la normal salen de las texturas
+        VAO = GpuVertexArray::generate();
+        uvBuffer = GpuBuffer::generate();
+        indexBuffer = GpuBuffer::generate();
+        glBindVertexArray(VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, uvBuffer.id());
+        glBufferData(GL_ARRAY_BUFFER, data.texCoords.size() * sizeof(float), data.texCoords.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.id());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(uint32_t), data.indices.data(), GL_STATIC_DRAW);
+
+        // Atributos por instancia; el puntero real se pone en cada draw (cambia el offset)
+        for (int attribute = 5; attribute <= 9; attribute++) {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+        glBindVertexArray(0);
+
+        gpuBytes = data.bytes();
+        clips = data.clips;
+        submeshes = data.submeshes;
+        data = VatData();
+        images.clear();
+        return true;
+    }
+
+    bool isLoaded() const { return (bool)VAO; }
+    const std::vector<VatClip>& getClips() const { return clips; }
+
+    // Parámetros de animación para una instancia que reproduce 'clip' con un desfase
+    glm::vec4 instanceAnim(size_t clip, float timeOffset) const {
+        const VatClip& c = clips[clip % clips.size()];
+        return glm::vec4((float)c.firstFrame, (float)c.frameCount, c.fps, timeOffset);
+    }
+
+    // El shader (variante VERTEX_ANIMATION) ya debe estar en uso con sus bloques enlazados.
+    // Las instancias (VatInstance) están en instanceBuffer a partir de offset.
+    void draw(Shader& shader, float time, GLuint instanceBuffer, GLintptr offset, GLsizei instanceCount) {
+        if (!VAO || instanceCount == 0)
+            return;
+        glm::vec3 boundsMin(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        glm::vec3 boundsMax(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        shader.setVec3("vatBoundsMin", boundsMin);
+        shader.setVec3("vatBoundsExtent", boundsMax - boundsMin);
+        shader.setInt("vatVertexCount", (int)header.vertexCount);
+        shader.setFloat("vatTime", time);
+        shader.setInt("texture_diffuse1", 0);
+        shader.setInt("vatPositions", 1);
+        shader.setInt("vatNormals", 2);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, positions.id());
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, normals.id());
+
+        glBindVertexArray(VAO.id());
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (int column = 0; column < 4; column++)
+            glVertexAttribPointer(5 + column, 4, GL_FLOAT, GL_FALSE, sizeof(VatInstance),
+                                  (void*)(offset + column * sizeof(glm::vec4)));
+        glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, sizeof(VatInstance), (void*)(offset + offsetof(VatInstance, anim)));
+        for (size_t i = 0; i < submeshes.size(); i++) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, diffuse[i].id());
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)submeshes[i].indexCount, GL_UNSIGNED_INT,
+                                    (void*)(submeshes[i].firstIndex * sizeof(uint32_t)), instanceCount);
+        }
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void report(const char* name) const {
+        std::printf("[VAT] %s: %u vertices, %zu clips, %u frames, %ux%u texels, %zu KB en GPU\n",
+                    name, header.vertexCount, clips.size(), header.frameCount, header.textureWidth, header.textureHeight,
+                    gpuBytes / 1024);
+    }
+
+private:
+    VatData data;                 // Hasta upload()
+    std::vector<ImageData> images;
+
+    VatHeader header;
+    std::vector<VatClip> clips;
+    std::vector<VatSubmesh> submeshes;
+    GpuTexture positions, normals;
+    std::vector<GpuTexture> diffuse;
+    GpuVertexArray VAO;
+    GpuBuffer uvBuffer, indexBuffer;
+    size_t gpuBytes = 0;
+
+    // Textura de datos: sin filtrado (se lee con texelFetch) ni mipmaps
+    GpuTexture createTexture(GLenum internalFormat, GLenum type, const void* pixels) const {
+        GpuTexture texture = GpuTexture::generate();
+        glBindTexture(GL_TEXTURE_2D, texture.id());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, (GLsizei)header.textureWidth, (GLsizei)header.textureHeight, 0,
+                     GL_RGBA, type, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texture;
+    }
+};
@@ -6,21 +6,117 @@ in vec3 Normal;
 in vec2 TexCoords;
 
 uniform sampler2D texture_diffuse1;
-uniform vec3 lightPos;   // Posición de la luz
-uniform vec3 viewPos;    // Posición de la cámara (para brillo especular, opcional)
+// Mismos bloques que basic.vert: viewPos = cámara (para brillo especular, opcional),
+// lightPos = dirección hacia la luz
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    mat4 lightSpace;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 model;
+    vec4 lightPos;
+};
+
+#ifdef ALPHA_TEST
+uniform float alphaCutoff = 0.5;
+#endif
+
+#ifdef EMISSIVE
+uniform float emissiveStrength = 4.0; // > 1: la escena es HDR y esto es lo que brilla
+#endif
+
+#ifdef SHADOWS
+// Mapa combinado de ShadowMap.h; la comparación la hace el hardware (GL_COMPARE_REF_TO_TEXTURE)
+uniform sampler2DShadow shadowMap;
+
+float shadowFactor(vec3 norm, vec3 lightDir)
+{
+    vec4 lightClip = lightSpace * vec4(FragPos, 1.0);
+    vec3 coord = lightClip.xyz / lightClip.w * 0.5 + 0.5;
+    if (any(lessThan(coord, vec3(0.0))) || any(greaterThan(coord, vec3(1.0))))
+        return 1.0; // Fuera del cuadro cubierto
+    // Más sesgo en superficies inclinadas respecto a la luz
+    float bias = max(0.002 * (1.0 - dot(norm, lightDir)), 0.0005);
+    // 4 muestras con filtrado bilineal de la comparación = 16 texels de PCF
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float lit = 0.0;
+    lit += texture(shadowMap, vec3(coord.xy + vec2(-0.5, -0.5) * texel, coord.z - bias));
+    lit += texture(shadowMap, vec3(coord.xy + vec2( 0.5, -0.5) * texel, coord.z - bias));
+    lit += texture(shadowMap, vec3(coord.xy + vec2(-0.5,  0.5) * texel, coord.z - bias));
+    lit += texture(shadowMap, vec3(coord.xy + vec2( 0.5,  0.5) * texel, coord.z - bias));
+    return lit * 0.25;
+}
+#endif
+
+#ifdef CLUSTERED_LIGHTS
+// Luces puntuales por cluster (ver LightClusters.h): cada fragmento busca su cluster y
+// recorre sólo esas luces
+uniform samplerBuffer clusterLights;    // 2 texels por luz: posición + radio, color + intensidad
+uniform usamplerBuffer clusterRanges;   // Por cluster: primer índice y cantidad
+uniform usamplerBuffer clusterIndices;  // Índices a clusterLights
+
+vec3 clusteredLighting(vec3 norm)
+{
+    vec4 clip = projection * view * vec4(FragPos, 1.0);
+    vec2 ndc = clip.xy / clip.w;
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    ivec3 grid = ivec3(clusterGrid.xyz);
+    ivec2 tile = clamp(ivec2((ndc * 0.5 + 0.5) * clusterGrid.xy), ivec2(0), grid.xy - 1);
+    int slice = clamp(int(floor(log(max(depth, 1e-4)) * clusterDepth.x + clusterDepth.y)), 0, grid.z - 1);
+    int cluster = (slice * grid.y + tile.y) * grid.x + tile.x;
+
+    uvec2 range = texelFetch(clusterRanges, cluster).xy;
+    vec3 total = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++) {
+        int light = int(texelFetch(clusterIndices, int(range.x + i)).x);
+        vec4 positionRadius = texelFetch(clusterLights, light * 2);
+        vec4 colorIntensity = texelFetch(clusterLights, light * 2 + 1);
+        vec3 toLight = positionRadius.xyz - FragPos;
+        float dist = length(toLight);
+        float falloff = clamp(1.0 - dist / positionRadius.w, 0.0, 1.0);
+        float diff = max(dot(norm, toLight / max(dist, 1e-4)), 0.0);
+        total += colorIntensity.rgb * colorIntensity.a * diff * falloff * falloff;
+    }
+    return total;
+}
+#endif
 
 void main()
 {
-    vec3 color = texture(texture_diffuse1, TexCoords).rgb;
+#ifdef DEPTH_ONLY
+    // La profundidad la escribe el hardware; no hay color que calcular
+    return;
+#endif
+#ifdef OUTLINE
+    // Color RGBA: Negro totalmente opaco
+    FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    return;
+#endif
+
+    vec4 texel = texture(texture_diffuse1, TexCoords);
+#ifdef ALPHA_TEST
+    if (texel.a < alphaCutoff)
+        discard;
+#endif
+    vec3 color = texel.rgb;
     vec3 norm = normalize(Normal);
     
     // --- CAMBIO CLAVE: LUZ TIPO SOL (DIRECTIONAL LIGHT) ---
     // En lugar de (lightPos - FragPos), usamos directamente lightPos como dirección
     // asumiendo que lightPos es un vector que apunta HACIA la luz (ej: arriba).
-    vec3 lightDir = normalize(lightPos); 
+    vec3 lightDir = normalize(lightPos.xyz);
 
     // Iluminación Difusa
     float diff = max(dot(norm, lightDir), 0.0);
+#ifdef SHADOWS
+    // Antes del cel shading: la sombra baja de nivel igual que una cara de espaldas al sol
+    diff *= shadowFactor(norm, lightDir);
+#endif
 
     // --- CEL SHADING ---
     float levels = 3.0;
@@ -32,5 +128,11 @@ void main()
     vec3 diffuse = color * toonDiff; 
     
     vec3 result = ambient + diffuse;
+#ifdef CLUSTERED_LIGHTS
+    result += color * clusteredLighting(norm);
+#endif
+#ifdef EMISSIVE
+    result = color * emissiveStrength;
+#endif
     FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
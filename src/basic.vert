@@ -3,23 +3,97 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+#ifdef SKINNED
+// Hasta 4 huesos por vértice
+layout (location = 3) in ivec4 aBoneIds;
+layout (location = 4) in vec4 aWeights;
+const int MAX_BONES = 100;
+uniform mat4 bones[MAX_BONES];
+#endif
+
+#ifdef INSTANCED
+// Matriz model por instancia (ocupa las locations 5, 6, 7 y 8)
+layout (location = 5) in mat4 aInstanceModel;
+#endif
+
+#ifdef VERTEX_ANIMATION
+// Animación horneada (ver VatFormat.h): aPos/aNormal no se usan, cada vértice lee su
+// posición y normal del frame actual con gl_VertexID
+layout (location = 9) in vec4 aInstanceAnim; // primer frame, frames, fps, desfase (s)
+uniform sampler2D vatPositions;
+uniform sampler2D vatNormals;
+uniform vec3 vatBoundsMin;
+uniform vec3 vatBoundsExtent;
+uniform int vatVertexCount;
+uniform float vatTime;
+
+ivec2 vatTexel(int frame)
+{
+    int index = frame * vatVertexCount + gl_VertexID;
+    int width = textureSize(vatPositions, 0).x;
+    return ivec2(index % width, index / width);
+}
+#endif
+
 // Salidas hacia el Fragment Shader
 out vec3 FragPos;  // Posición del vértice en el mundo
 out vec3 Normal;   // Normal de la superficie
 out vec2 TexCoords;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Bloques que llena el StreamBuffer (ver UniformBlocks.h)
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    mat4 lightSpace;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 model;
+    vec4 lightPos;
+};
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
+#ifdef INSTANCED
+    mat4 modelMatrix = aInstanceModel;
+#else
+    mat4 modelMatrix = model;
+#endif
+
+    vec4 localPos = vec4(aPos, 1.0);
+    vec3 localNormal = aNormal;
+#ifdef VERTEX_ANIMATION
+    // Interpolamos entre los dos frames vecinos del clip (el último enlaza con el primero)
+    float frames = aInstanceAnim.y;
+    float frame = mod((vatTime + aInstanceAnim.w) * aInstanceAnim.z, frames);
+    int frame0 = int(frame);
+    int frame1 = int(mod(float(frame0 + 1), frames));
+    float blend = fract(frame);
+    int first = int(aInstanceAnim.x);
+    ivec2 texel0 = vatTexel(first + frame0);
+    ivec2 texel1 = vatTexel(first + frame1);
+    vec3 unitPos = mix(texelFetch(vatPositions, texel0, 0).xyz, texelFetch(vatPositions, texel1, 0).xyz, blend);
+    localPos = vec4(vatBoundsMin + unitPos * vatBoundsExtent, 1.0);
+    localNormal = mix(texelFetch(vatNormals, texel0, 0).xyz, texelFetch(vatNormals, texel1, 0).xyz, blend);
+#endif
+#ifdef SKINNED
+    mat4 skin = bones[aBoneIds.x] * aWeights.x
+              + bones[aBoneIds.y] * aWeights.y
+              + bones[aBoneIds.z] * aWeights.z
+              + bones[aBoneIds.w] * aWeights.w;
+    localPos = skin * localPos;
+    localNormal = mat3(skin) * localNormal;
+#endif
+
+    FragPos = vec3(modelMatrix * localPos);
     
     // Calculamos la normal corregida (importante si escalas el modelo)
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    Normal = mat3(transpose(inverse(modelMatrix))) * localNormal;  
     
     TexCoords = aTexCoords;
     
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * modelMatrix * localPos;
 }
\ No newline at end of file
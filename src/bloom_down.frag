@@ -0,0 +1,75 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D source;
+uniform vec2 sourceRegion;  // Parte de la textura fuente que tiene datos este frame
+uniform vec2 sourceTexel;   // 1 / tamaño de la textura fuente
+uniform bool prefilter;     // Sólo el primer nivel: umbral y promedio de Karis
+uniform vec4 threshold;     // x = umbral, y = umbral - rodilla, z = 2 * rodilla, w = 0.25 / rodilla
+
+vec3 tap(vec2 uv, vec2 offset)
+{
+    return texture(source, clamp(uv + offset * sourceTexel, sourceTexel * 0.5, sourceRegion - sourceTexel * 0.5)).rgb;
+}
+
+// Un píxel muy brillante y aislado no debe parpadear al moverse: cada grupo pesa menos
+// cuanto más brilla (promedio de Karis)
+float karisWeight(vec3 c)
+{
+    return 1.0 / (1.0 + max(c.r, max(c.g, c.b)));
+}
+
+// Sólo pasa lo que supera el umbral, con una rodilla suave para no cortar en seco
+vec3 applyThreshold(vec3 c)
+{
+    float brightness = max(c.r, max(c.g, c.b));
+    float soft = clamp(brightness - threshold.y, 0.0, threshold.z);
+    soft = soft * soft * threshold.w;
+    float contribution = max(soft, brightness - threshold.x) / max(brightness, 1e-4);
+    return c * contribution;
+}
+
+void main()
+{
+    vec2 uv = TexCoord * sourceRegion;
+
+    // 13 muestras en 5 grupos de 2x2 que se solapan (filtro de Jimenez, CoD:AW): la mitad
+    // de resolución sin el aliasing de un promedio de 4
+    vec3 a = tap(uv, vec2(-2.0,  2.0));
+    vec3 b = tap(uv, vec2( 0.0,  2.0));
+    vec3 c = tap(uv, vec2( 2.0,  2.0));
+    vec3 d = tap(uv, vec2(-2.0,  0.0));
+    vec3 e = tap(uv, vec2( 0.0,  0.0));
+    vec3 f = tap(uv, vec2( 2.0,  0.0));
+    vec3 g = tap(uv, vec2(-2.0, -2.0));
+    vec3 h = tap(uv, vec2( 0.0, -2.0));
+    vec3 i = tap(uv, vec2( 2.0, -2.0));
+    vec3 j = tap(uv, vec2(-1.0,  1.0));
+    vec3 k = tap(uv, vec2( 1.0,  1.0));
+    vec3 l = tap(uv, vec2(-1.0, -1.0));
+    vec3 m = tap(uv, vec2( 1.0, -1.0));
+
+    vec3 groups[5] = vec3[5]((j + k + l + m) * 0.25,
+                             (a + b + d + e) * 0.25,
+                             (b + c + e + f) * 0.25,
+                             (d + e + g + h) * 0.25,
+                             (e + f + h + i) * 0.25);
+    float weights[5] = float[5](0.5, 0.125, 0.125, 0.125, 0.125);
+
+    vec3 result = vec3(0.0);
+    if (prefilter) {
+        float total = 0.0;
+        for (int n = 0; n < 5; n++) {
+            float w = weights[n] * karisWeight(groups[n]);
+            result += groups[n] * w;
+            total += w;
+        }
+        result = applyThreshold(result / total);
+    } else {
+        for (int n = 0; n < 5; n++)
+            result += groups[n] * weights[n];
+    }
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D source;   // Nivel más chico (ya con lo que subió de abajo)
+uniform vec2 sourceRegion;
+uniform vec2 sourceTexel;
+uniform float radius;       // En texels de la fuente
+
+vec3 tap(vec2 uv, vec2 offset)
+{
+    return texture(source, clamp(uv + offset * radius * sourceTexel, sourceTexel * 0.5, sourceRegion - sourceTexel * 0.5)).rgb;
+}
+
+void main()
+{
+    vec2 uv = TexCoord * sourceRegion;
+
+    // Filtro tienda 3x3: se suma (blend aditivo) al nivel de destino
+    vec3 result = tap(uv, vec2(0.0, 0.0)) * 4.0;
+    result += (tap(uv, vec2(-1.0, 0.0)) + tap(uv, vec2(1.0, 0.0)) + tap(uv, vec2(0.0, -1.0)) + tap(uv, vec2(0.0, 1.0))) * 2.0;
+    result += tap(uv, vec2(-1.0, -1.0)) + tap(uv, vec2(1.0, -1.0)) + tap(uv, vec2(-1.0, 1.0)) + tap(uv, vec2(1.0, 1.0));
+    FragColor = vec4(result / 16.0, 1.0);
+}
@@ -0,0 +1,61 @@
+#version 330 core
+// Hoja de pasto instanciada (ver Grass.h / GrassRenderer.h). Usa basic.frag como fragment shader.
+layout (location = 0) in vec2 aBlade;     // x: lado (-1 a 1), y: altura (0 a 1)
+layout (location = 1) in vec4 aInstance;  // Base en el mundo + valor aleatorio
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    mat4 lightSpace;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 model;
+    vec4 lightPos;
+};
+
+uniform float time;
+uniform float bladesPerChunk;
+uniform vec2 densityRange;  // Distancia con todas las hojas y sin ninguna (Grass::density)
+uniform vec2 bladeSize;     // Ancho y alto base
+uniform vec4 wind;          // Dirección (xy, normalizada), fuerza, velocidad
+
+void main()
+{
+    vec3 base = aInstance.xyz;
+    float random = aInstance.w;
+
+    // La hoja i del chunk se ve mientras i / bladesPerChunk quede debajo de la densidad a su
+    // distancia; cerca del límite se encoge en vez de desaparecer de golpe
+    float density = 1.0 - smoothstep(densityRange.x, densityRange.y, distance(base, viewPos.xyz));
+    float rank = float(gl_InstanceID) / bladesPerChunk;
+    float grow = clamp((density - rank) * 10.0, 0.0, 1.0);
+
+    float angle = random * 6.2831853;
+    vec2 facing = vec2(cos(angle), sin(angle));
+    float height = bladeSize.y * (0.6 + 0.8 * fract(random * 13.37)) * grow;
+    float width = bladeSize.x * grow;
+
+    // Viento: ondas que recorren el campo en la dirección del viento, más fuertes en la punta
+    float t = aBlade.y;
+    float phase = dot(base.xz, wind.xy) * 0.35 - time * wind.w + random * 2.0;
+    float sway = wind.z * (0.55 + 0.45 * sin(phase)) * t * t;
+    vec2 bend = wind.xy * sway;
+
+    vec3 world = base;
+    world.xz += facing * (aBlade.x * width) + bend * height;
+    world.y += t * height * (1.0 - 0.5 * sway * sway);  // La punta baja al doblarse
+
+    FragPos = world;
+    // Casi hacia arriba: las dos caras se iluminan igual y se parecen al suelo
+    Normal = normalize(vec3(-facing.y * 0.3 + bend.x, 1.0, facing.x * 0.3 + bend.y));
+    TexCoords = base.xz * 0.5;  // El color del suelo debajo de la hoja
+    gl_Position = projection * view * vec4(world, 1.0);
+}
@@ -6,27 +6,69 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Shader.h"
+#include "ShaderPermutations.h"
 #include "Model.h"
 #include "Sphere.h"
+#include "Bezier.h"
+#include "Bloom.h"
+#include "Components.h"
+#include "DynamicResolution.h"
+#include "InputRecorder.h"
+#include "FrameStats.h"
+#include "GpuResources.h"
+#include "Grass.h"
+#include "GrassRenderer.h"
+#include "JobSystem.h"
+#include "LightClusterBuffers.h"
+#include "LightClusters.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "AllocationCounter.h"
+#include "AnimationScheduler.h"
+#include "OcclusionCulling.h"
+#include "ParticleRenderer.h"
+#include "ParticleSystem.h"
+#include "ProjectilePool.h"
+#include "Registry.h"
+#include "RenderGraph.h"
+#include "RenderSnapshot.h"
+#include "SceneGraph.h"
+#include "ShadowMap.h"
+#include "StreamBuffer.h"
+#include "Terrain.h"
+#include "TerrainRenderer.h"
+#include "TripleBuffer.h"
+#include "UniformBlocks.h"
+#include "VertexAnimation.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <string>
 #include <iostream>
 
 // --- Configuraciones ---
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// Variables de Cámara y Jugador
-glm::vec3 cameraPos   = glm::vec3(0.0f, 2.0f, 6.0f);
 glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f, 0.0f);
 
-glm::vec3 gokuPos = glm::vec3(0.0f, 0.0f, 0.0f); 
-float gokuAngle = 0.0f;       // Hacia donde mira Goku (controlado por A/D)
-float cameraAngleAround = 0.0f; // Hacia donde mira la cámara (controlado por Mouse)
+// Entidades: jugador (Goku), cámara y escenario. Su estado vive en componentes
+// (Components.h) y lo avanzan los sistemas de updateSimulation.
+Registry registry;
+Entity player, camera, sky;
 
-// Variables del Ataque
-bool isAttacking = false;
-float attackTime = 0.0f; 
-glm::vec3 spherePos;     
+// Clips del jugador (si los FBX traen animación) y quién decide cuándo evaluar cada pose
+const CompressedAnimationClip* idleClip = nullptr;
+const CompressedAnimationClip* runClip = nullptr;
+AnimationScheduler animationScheduler;
+
+// Bolas de energía en vuelo (arreglos propios, ver Weapon)
+ProjectilePool projectiles(4096);
 
 // Variables de mouse
 bool firstMouse = true;
@@ -35,29 +77,143 @@ float lastX = SCR_WIDTH / 2.0;
 // Temporizador
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
+double simTime = 0.0;  // Suma de deltaTime (determinista en la reproducción)
+
+// Multitud alrededor del escenario, animada con texturas horneadas (vat_bake)
+const int CROWD_SIZE = 256;
+
+// Entrada: en vivo, grabando a archivo o reproduciendo un archivo a paso fijo
+enum class InputMode { LIVE, RECORD, REPLAY };
+InputMode inputMode = InputMode::LIVE;
+InputState input;
+InputRecorder recorder;
+InputReplayer replayer;
+
+// Partículas del ataque: estela de cada bola, aura de Goku al disparar y explosión al final
+ParticleSystem particles(1 << 17);
+ParticleEmitter trailSettings; // La estela se emite por proyectil con esta configuración
+int auraEmitter, impactEmitter;
+
+// Transformaciones de los objetos de la escena (los proyectiles van aparte, en su pool)
+SceneGraph sceneGraph;
+uint32_t gokuMeshNode;
+
+// Culling por oclusión en CPU: las entidades con Occluder tapan a Goku, la multitud y los
+// proyectiles (ver updateSimulation)
+OcclusionBuffer occlusion(256, 128);
+
+// Luces puntuales del frame (una por bola de energía) y su reparto en clusters
+std::vector<PointLight> pointLights;
+LightClusterBuilder lightClusters;
+const float CLUSTER_NEAR = 1.0f, CLUSTER_FAR = 100.0f;
+
+// Luz tipo SOL (dirección fija desde arriba a la derecha, hacia la luz)
+const glm::vec3 SUN_DIRECTION(50.0f, 100.0f, 50.0f);
+
+// Suelo: terreno por chunks alrededor del jugador (su versión invalida las sombras estáticas)
+Terrain terrain;
+// Cuadro de las sombras: lo usan el render (ShadowMap) y la simulación (chunks que lo tocan)
+ShadowSettings shadowSettings;
+// Pasto instanciado sobre los chunks cercanos del terreno
+Grass grass;
+
+// Tareas en paralelo (carga de assets, y más adelante culling/animación/partículas)
+std::unique_ptr<JobSystem> jobs;
+
+// Hilo de render: es dueño del contexto OpenGL y dibuja el último RenderSnapshot que
+// publicó la simulación. Mientras dibuja el frame N, el hilo principal ya simula el N+1.
+TripleBuffer<RenderSnapshot> snapshots;
+uint64_t simFrameIndex = 0;                 // Último frame simulado (hilo principal)
+float aspectRatio = (float)SCR_WIDTH / (float)SCR_HEIGHT;  // Se conserva al minimizar (0x0)
+std::atomic<uint64_t> renderFrameIndex{0};  // Último frame que tomó el render
+std::atomic<bool> renderRunning{true};
+std::atomic<int> framebufferWidth{(int)SCR_WIDTH};
+std::atomic<int> framebufferHeight{(int)SCR_HEIGHT};
+
+// Asignaciones de heap por frame en estado estable (deberían ser cero)
+AllocationWatch simAllocations("simulacion");
+AllocationWatch renderAllocations("render");
+
+// Recursos de GPU de la escena (se crean en el hilo principal antes de ceder el contexto).
+// Los objetos de OpenGL se borran solos al soltar la última referencia (GpuResources).
+struct SceneResources {
+    Shader* ourShader;
+    Shader* outlineShader;
+    Shader* instancedShader;
+    Shader* crowdShader;
+    Model* idleModel;
+    Model* runModel;
+    Sphere* energyBall;
+    Sphere* skyDome;
+    GpuTexture floorTexture, poderTexture, skyTexture;
+    StreamBuffer* stream;   // Datos dinámicos por frame (sólo el hilo de render)
+    ParticleRenderer* particleRenderer;
+    VatCrowd* crowd;        // Sin instancias si no hay .vat horneado
+    DynamicResolution* resolution;  // Viewport de la escena y escalado al backbuffer
+    LightClusterBuffers* lightBuffers;
+    RenderGraph* graph;     // Pases del frame (se arman en el hilo de render)
+    Bloom* bloom;
+    ShadowMap* shadows;
+    Shader* depthShader;            // Variantes DEPTH_ONLY para los oclusores de las sombras
+    Shader* depthInstancedShader;
+    Shader* depthCrowdShader;
+    TerrainRenderer* terrainRenderer;
+    Shader* terrainShader;
+    Shader* terrainDepthShader;
+    GrassRenderer* grassRenderer;
+    Shader* grassShader;
+};
 
 // Funciones
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window);
+void fireAttack(const Transform& transform, Weapon& weapon);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void applyCursorX(float xpos);
+void updateSimulation(RenderSnapshot& snapshot);
+void renderScene(const RenderSnapshot& snapshot, SceneResources& scene);
+void renderShadowCasters(const RenderSnapshot& snapshot, SceneResources& scene, bool staticCasters);
+void renderThreadMain(GLFWwindow* window, SceneResources scene, bool vsync);
+void runScene(GLFWwindow* window, const std::string& inputPath, const std::string& csvPath,
+              const DynamicResolutionSettings& resolutionSettings, const BloomSettings& bloomSettings);
 
-// Bezier
-glm::vec3 calculateBezier(float t, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
-    float u = 1.0f - t;
-    float tt = t * t;
-    float uu = u * u;
-    float uuu = uu * u;
-    float ttt = tt * t;
-    glm::vec3 p = uuu * p0; 
-    p += 3 * uu * t * p1;   
-    p += 3 * u * tt * p2;   
-    p += ttt * p3;          
-    return p;
-}
-
-int main()
+int main(int argc, char** argv)
 {
+    // Argumentos: --record archivo | --replay archivo [--csv reporte.csv] [--single-thread]
+    //             [--render-scale min max] [--target-fps fps] [--bloom intensidad]
+    std::string inputPath, csvPath;
+    bool singleThread = false;
+    DynamicResolutionSettings resolutionSettings;
+    BloomSettings bloomSettings;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            inputMode = InputMode::RECORD;
+            inputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            inputMode = InputMode::REPLAY;
+            inputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--single-thread") == 0) {
+            singleThread = true;
+        } else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 2 < argc) {
+            resolutionSettings.minScale = (float)std::atof(argv[++i]);
+            resolutionSettings.maxScale = (float)std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--target-fps") == 0 && i + 1 < argc) {
+            float fps = (float)std::atof(argv[++i]);
+            if (fps > 0.0f)
+                resolutionSettings.targetMs = 1000.0f / fps;
+        } else if (std::strcmp(argv[i], "--bloom") == 0 && i + 1 < argc) {
+            bloomSettings.intensity = std::max(0.0f, (float)std::atof(argv[++i])); // 0 = sin bloom
+        }
+    }
+    jobs.reset(new JobSystem(singleThread ? 0 : JobSystem::defaultWorkerCount()));
+    // Una sub-arena por hilo: principal, render y cada worker
+    FrameArena::init(jobs->threadCount() + 1, 4 << 20);
+    if (inputMode == InputMode::REPLAY && !replayer.load(inputPath))
+        return -1;
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -75,191 +231,832 @@ int main()
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { return -1; }
+    glExt.load();
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Shaders
-    Shader ourShader("src/basic.vert", "src/basic.frag");
-    Shader outlineShader("src/outline.vert", "src/outline.frag");
+    runScene(window, inputPath, csvPath, resolutionSettings, bloomSettings);
+
+    // Todo lo de la escena ya se soltó al salir de runScene: se borra aquí, con el contexto
+    // en este hilo y antes de destruir la ventana (no debe quedar nada por borrar)
+    GpuResources::flush();
+    if (inputMode == InputMode::REPLAY)
+        GpuResources::report();
+    glfwMakeContextCurrent(NULL);
+    jobs.reset();
+    glfwTerminate();
+    return 0;
+}
+
+// Crea la escena, corre la simulación con el hilo de render hasta cerrar la ventana e
+// imprime los reportes. Los recursos de GPU son locales: se sueltan al regresar.
+void runScene(GLFWwindow* window, const std::string& inputPath, const std::string& csvPath,
+              const DynamicResolutionSettings& resolutionSettings, const BloomSettings& bloomSettings)
+{
+    // Shaders: todas las variantes de basic.vert/frag se compilan juntas al inicio
+    ShaderPermutations basicShaders("src/basic.vert", "src/basic.frag");
+    // (las bolas de energía son las luces: ellas mismas no reciben luces puntuales, brillan solas)
+    const uint32_t LIT = SHADER_CLUSTERED_LIGHTS | SHADER_SHADOWS;
+    basicShaders.request(LIT);
+    basicShaders.request(SHADER_OUTLINE);
+    basicShaders.request(SHADER_INSTANCED | SHADER_EMISSIVE);
+    basicShaders.request(SHADER_INSTANCED | SHADER_VERTEX_ANIMATION | LIT);
+    basicShaders.request(SHADER_DEPTH_ONLY);
+    basicShaders.request(SHADER_INSTANCED | SHADER_DEPTH_ONLY);
+    basicShaders.request(SHADER_INSTANCED | SHADER_VERTEX_ANIMATION | SHADER_DEPTH_ONLY);
+    basicShaders.compileAll();
+    Shader& ourShader = basicShaders.get(LIT);
+    Shader& outlineShader = basicShaders.get(SHADER_OUTLINE);
+    Shader& instancedShader = basicShaders.get(SHADER_INSTANCED | SHADER_EMISSIVE);
+    Shader& crowdShader = basicShaders.get(SHADER_INSTANCED | SHADER_VERTEX_ANIMATION | LIT);
+    Shader& depthShader = basicShaders.get(SHADER_DEPTH_ONLY);
+    Shader& depthInstancedShader = basicShaders.get(SHADER_INSTANCED | SHADER_DEPTH_ONLY);
+    Shader& depthCrowdShader = basicShaders.get(SHADER_INSTANCED | SHADER_VERTEX_ANIMATION | SHADER_DEPTH_ONLY);
+    // El terreno comparte el fragment shader; su vertex shader saca la altura de una textura
+    ShaderPermutations terrainShaders("src/terrain.vert", "src/basic.frag");
+    terrainShaders.request(LIT);
+    terrainShaders.request(SHADER_DEPTH_ONLY);
+    terrainShaders.compileAll();
+    Shader& terrainShader = terrainShaders.get(LIT);
+    Shader& terrainDepthShader = terrainShaders.get(SHADER_DEPTH_ONLY);
+    ShaderPermutations grassShaders("src/grass.vert", "src/basic.frag");
+    grassShaders.request(LIT);
+    grassShaders.compileAll();
+    Shader& grassShader = grassShaders.get(LIT);
 
-    // Modelos
-    Model idleModel("assets/goku/GokuIdle.fbx");
-    Model runModel("assets/goku/GokuRun.fbx");
+    // Modelos y texturas: la parte de CPU (Assimp, decodificar imágenes) corre en paralelo
+    // en los workers; después se suben a la GPU aquí, en el hilo con el contexto.
+    // Goku sólo se dibuja (no hay picking ni colisiones contra su malla): la geometría de
+    // CPU se libera en cuanto está en la GPU.
+    Model idleModel(false, GEOMETRY_DROP), runModel(false, GEOMETRY_DROP);
+    ImageData floorImage, poderImage, skyImage;
+    VatCrowd crowd;
+    bool crowdImported = false;
+    Job* loading = jobs->create([] {});
+    jobs->run(jobs->create([&] { idleModel.import("assets/goku/GokuIdle.fbx"); }, loading));
+    jobs->run(jobs->create([&] { runModel.import("assets/goku/GokuRun.fbx"); }, loading));
+    jobs->run(jobs->create([&] { floorImage = loadImageData("grass.jpg", "assets/textures"); }, loading));
+    jobs->run(jobs->create([&] { poderImage = loadImageData("rayo.jpg", "assets/textures"); }, loading));
+    jobs->run(jobs->create([&] { skyImage   = loadImageData("sky.jpg", "assets/textures"); }, loading));
+    jobs->run(jobs->create([&] { crowdImported = crowd.import("assets/goku/GokuRun.vat"); }, loading));
+    jobs->run(loading);
+    jobs->wait(loading);
+
+    idleModel.upload();
+    runModel.upload();
+    idleModel.printMemoryReport("GokuIdle");
+    runModel.printMemoryReport("GokuRun");
     
     // Esferas (Energía y Cielo)
     Sphere energyBall(0.3f, 24, 24);
-    Sphere skyDome(50.0f, 32, 32); // Esfera gigante (Radio 50) para el cielo
-
-    // Suelo
-    float planeVertices[] = {
-         50.0f, -0.0f,  50.0f,  0.0f, 1.0f, 0.0f,  50.0f,  0.0f,
-        -50.0f, -0.0f,  50.0f,  0.0f, 1.0f, 0.0f,   0.0f,  0.0f,
-        -50.0f, -0.0f, -50.0f,  0.0f, 1.0f, 0.0f,   0.0f, 50.0f,
+    // Esfera gigante para el cielo: casi hasta el plano lejano (100) para que se vea el terreno
+    Sphere skyDome(90.0f, 32, 32);
 
-         50.0f, -0.0f,  50.0f,  0.0f, 1.0f, 0.0f,  50.0f,  0.0f,
-        -50.0f, -0.0f, -50.0f,  0.0f, 1.0f, 0.0f,   0.0f, 50.0f,
-         50.0f, -0.0f, -50.0f,  0.0f, 1.0f, 0.0f,  50.0f, 50.0f
-    };
-    unsigned int planeVAO, planeVBO;
-    glGenVertexArrays(1, &planeVAO);
-    glGenBuffers(1, &planeVBO);
-    glBindVertexArray(planeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glBindVertexArray(0);
+    // Suelo: las alturas se arman en los workers; los chunks cercanos quedan listos antes
+    // del primer frame y el resto se carga mientras el jugador camina
+    terrain.init(TerrainSettings(), "assets/terrain/heightmap.png", jobs.get());
+    terrain.setShadowBox(glm::vec3(0.0f), shadowSettings.halfExtent);
+    terrain.preload(glm::vec3(0.0f), jobs.get());
+    TerrainRenderer terrainRenderer;
+    terrainRenderer.init();
+    grass.init(GrassSettings(), terrain.chunkSize());
+    GrassRenderer grassRenderer;
+    grassRenderer.init(grass);
 
     // Texturas
-    unsigned int floorTexture = TextureFromFile("grass.jpg", "assets/textures");
-    unsigned int poderTexture = TextureFromFile("rayo.jpg", "assets/textures");
-    unsigned int skyTexture   = TextureFromFile("sky.jpg", "assets/textures"); 
+    GpuTexture floorTexture = uploadTexture(floorImage);
+    GpuTexture poderTexture = uploadTexture(poderImage);
+    GpuTexture skyTexture   = uploadTexture(skyImage);
+
+    // Datos dinámicos: 3 regiones de 8 MB (bloques de uniforms e instancias de partículas;
+    // 128K partículas ocupan 4 MB)
+    StreamBuffer stream;
+    stream.init(8 << 20);
+    ourShader.bindUniformBlock("FrameData", UBO_FRAME);
+    ourShader.bindUniformBlock("ObjectData", UBO_OBJECT);
+    outlineShader.bindUniformBlock("FrameData", UBO_FRAME);
+    outlineShader.bindUniformBlock("ObjectData", UBO_OBJECT);
+    instancedShader.bindUniformBlock("FrameData", UBO_FRAME);
+    instancedShader.bindUniformBlock("ObjectData", UBO_OBJECT);
+    crowdShader.bindUniformBlock("FrameData", UBO_FRAME);
+    crowdShader.bindUniformBlock("ObjectData", UBO_OBJECT);
+    for (Shader* shader : { &depthShader, &depthInstancedShader, &depthCrowdShader, &terrainShader, &terrainDepthShader, &grassShader }) {
+        shader->bindUniformBlock("FrameData", UBO_FRAME);
+        shader->bindUniformBlock("ObjectData", UBO_OBJECT);
+    }
+
+    // Luces puntuales: los búferes se llenan cada frame con lo que asignó la simulación
+    LightClusterBuffers lightBuffers;
+    lightBuffers.init();
+    LightClusterBuffers::bindSamplers(ourShader);
+    LightClusterBuffers::bindSamplers(crowdShader);
+    LightClusterBuffers::bindSamplers(terrainShader);
+    LightClusterBuffers::bindSamplers(grassShader);
+    pointLights.reserve(MAX_CLUSTER_LIGHTS);
+
+    ParticleRenderer particleRenderer;
+    particleRenderer.init();
+
+    DynamicResolution dynamicResolution;
+    dynamicResolution.init(resolutionSettings);
+    Bloom bloom;
+    bloom.init(bloomSettings);
+    ShadowMap shadows;
+    shadows.init(shadowSettings);
+    ShadowMap::bindSampler(ourShader);
+    ShadowMap::bindSampler(crowdShader);
+    ShadowMap::bindSampler(terrainShader);
+    ShadowMap::bindSampler(grassShader);
+    TerrainRenderer::bindSampler(terrainShader);
+    TerrainRenderer::bindSampler(terrainDepthShader);
+    RenderGraph renderGraph;
+
+    SceneResources scene = { &ourShader, &outlineShader, &instancedShader, &crowdShader, &idleModel, &runModel, &energyBall, &skyDome,
+                             floorTexture, poderTexture, skyTexture, &stream, &particleRenderer, &crowd,
+                             &dynamicResolution, &lightBuffers, &renderGraph, &bloom, &shadows,
+                             &depthShader, &depthInstancedShader, &depthCrowdShader,
+                             &terrainRenderer, &terrainShader, &terrainDepthShader, &grassRenderer, &grassShader };
+
+    // Emisores del ataque (se activan y mueven en updateSimulation). trailSettings.rate es
+    // el total por segundo, repartido entre los proyectiles vivos.
+    trailSettings.type = EMITTER_TRAIL;
+    trailSettings.color = glm::vec3(0.4f, 0.7f, 1.0f);
+    trailSettings.rate = 60000.0f;
+    trailSettings.speed = 0.6f;
+    trailSettings.lifetime = 1.2f;
+    trailSettings.size = 0.08f;
+
+    ParticleEmitter aura;
+    aura.type = EMITTER_AURA;
+    aura.color = glm::vec3(1.0f, 0.85f, 0.3f);
+    aura.rate = 20000.0f;
+    aura.speed = 1.5f;
+    aura.lifetime = 1.0f;
+    aura.size = 0.06f;
+    aura.radius = 0.8f;
+    aura.lift = 1.0f;
+    auraEmitter = particles.addEmitter(aura);
+
+    ParticleEmitter impact;
+    impact.type = EMITTER_BURST;
+    impact.color = glm::vec3(0.6f, 0.85f, 1.0f);
+    impact.speed = 6.0f;
+    impact.lifetime = 1.5f;
+    impact.size = 0.1f;
+    impact.lift = -4.0f;
+    impactEmitter = particles.addEmitter(impact);
+    particles.budgetMs = 2.0f;
+
+    // Jerarquía de la escena. El FBX de Goku (exportado de Blender, en cm) ya trae en su
+    // nodo la rotación de -90° en X y la escala x100 que Model respeta; aquí sólo se
+    // regresa a metros y se centra la malla (antes: rotate -90° + translate(0, -1, 0) a mano).
+    const glm::mat4 gokuMeshLocal = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(0.01f));
+    sceneGraph.reserve(8);
+    uint32_t gokuNode = sceneGraph.addNode(SceneGraph::NO_PARENT);
+    gokuMeshNode = sceneGraph.addNode(gokuNode, gokuMeshLocal);
+
+    // Entidades. Los pools se reservan aquí para que la simulación no asigne memoria.
+    registry.reserve(16);
+    player = registry.create();
+    registry.add<Transform>(player);
+    registry.add<PlayerControl>(player);
+    registry.add<Weapon>(player);
+    registry.add<SceneNode>(player, SceneNode{ gokuNode });
+    if (!idleModel.animations.empty())
+        idleClip = &idleModel.animations[0];
+    if (!runModel.animations.empty())
+        runClip = &runModel.animations[0];
+    if (idleClip || runClip) {
+        Animator animator;
+        animator.radius = 1.2f;
+        // La pose ya con capacidad para el clip más grande: cambiar de clip no asigna memoria
+        animator.pose.reserve(std::max(idleClip ? idleClip->tracks.size() : 0, runClip ? runClip->tracks.size() : 0));
+        animator.setClip(idleClip ? idleClip : runClip);
+        registry.add<Animator>(player, std::move(animator));
+    }
+
+    camera = registry.create();
+    OrbitCamera orbit;
+    orbit.target = player;
+    registry.add<OrbitCamera>(camera, orbit);
+
+    // El cielo sigue al jugador (el suelo es el terreno, fuera del registro)
+    sky = registry.create();
+    registry.add<Transform>(sky);
+    registry.add<FollowTarget>(sky, FollowTarget{ player });
+    registry.add<SceneNode>(sky, SceneNode{ sceneGraph.addNode(SceneGraph::NO_PARENT) });
+
+    // Multitud: anillos de espectadores mirando al centro, cada uno con su clip y desfase.
+    // Se quedan quietos: su matriz y su animación se calculan aquí y cada tick sólo se
+    // copian las instancias que pasan el culling.
+    if (crowdImported && crowd.upload()) {
+        registry.pool<CrowdMember>().reserve(CROWD_SIZE);
+        registry.pool<Transform>().reserve(CROWD_SIZE + 8);
+        for (int i = 0; i < CROWD_SIZE; i++) {
+            const int perRing = 64;
+            float radius = 18.0f + 3.0f * (float)(i / perRing);
+            float angle = 360.0f * (float)(i % perRing) / perRing + 2.8f * (float)(i / perRing);
+            Transform transform;
+            transform.position = glm::vec3(sin(glm::radians(angle)) * radius, 0.0f, cos(glm::radians(angle)) * radius);
+            transform.position.y = terrain.height(transform.position.x, transform.position.z);
+            transform.yaw = angle + 180.0f;
+            CrowdMember member;
+            member.clip = (uint32_t)i;
+            member.timeOffset = (float)((i * 7919) % 1000) / 1000.0f * 4.0f;
+            member.model = glm::translate(glm::mat4(1.0f), transform.position);
+            member.model = glm::rotate(member.model, glm::radians(transform.yaw), glm::vec3(0.0f, 1.0f, 0.0f)) * gokuMeshLocal;
+            member.anim = crowd.instanceAnim(member.clip, member.timeOffset);
+            Entity e = registry.create();
+            registry.add<Transform>(e, transform);
+            registry.add<CrowdMember>(e, member);
+        }
+        crowd.report("GokuRun");
+    }
+    animationScheduler.reserve(registry.pool<Animator>().size());
+
+    // Cedemos el contexto al hilo de render. En reproducción medimos el costo real del
+    // frame, sin esperar al VSync.
+    glfwMakeContextCurrent(NULL);
+    std::thread renderThread(renderThreadMain, window, scene, inputMode != InputMode::REPLAY);
+
+    FrameStats frameStats;
+    double frameStart = glfwGetTime();
+    lastFrame = static_cast<float>(frameStart);
+    if (inputMode == InputMode::RECORD)
+        recorder.begin(frameStart);
 
     while (!glfwWindowShouldClose(window))
     {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        glfwPollEvents();
+
+        if (inputMode == InputMode::REPLAY) {
+            // Paso fijo: la simulación no depende del tiempo real
+            deltaTime = replayer.fixedDelta;
+            if (!replayer.step(input))
+                break;
+            if (input.hasCursor)
+                applyCursorX(input.cursorX);
+        } else {
+            float currentFrame = static_cast<float>(glfwGetTime());
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+
+            input.keys = pollKeyboard(window);
+            if (inputMode == InputMode::RECORD)
+                recorder.recordKeys(glfwGetTime(), input.keys);
+        }
+
+        FrameArena::beginFrame();
+        simAllocations.beginFrame();
 
         processInput(window);
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        RenderSnapshot& snapshot = snapshots.back();
+        updateSimulation(snapshot);
+        snapshots.publish();
 
-        // --- CÁMARA ORBITAL ---
-        // La cámara ahora depende del mouse (cameraAngleAround) en lugar de Goku
-        float distanceFromPlayer = 7.0f;
-        float heightFromPlayer = 3.0f;
+        if (simAllocations.endFrame())
+            std::cout << "AVISO: la simulacion asigno memoria en un frame estable (frame " << simFrameIndex << ")" << std::endl;
 
-        // Calculamos posición de la cámara rotando alrededor de Goku
-        glm::vec3 targetCameraPos;
-        targetCameraPos.x = gokuPos.x + sin(glm::radians(cameraAngleAround)) * distanceFromPlayer;
-        targetCameraPos.z = gokuPos.z + cos(glm::radians(cameraAngleAround)) * distanceFromPlayer;
-        targetCameraPos.y = gokuPos.y + heightFromPlayer;
+        // No dejamos que la simulación se adelante más de un frame al render
+        while (renderFrameIndex.load() + 1 < simFrameIndex && renderRunning.load())
+            std::this_thread::yield();
+
+        double frameEnd = glfwGetTime();
+        frameStats.add((frameEnd - frameStart) * 1000.0);
+        frameStart = frameEnd;
+    }
+
+    renderRunning.store(false);
+    renderThread.join();
+    // El render soltó el contexto: lo retoma este hilo para borrar la escena al salir
+    glfwMakeContextCurrent(window);
+
+    if (inputMode == InputMode::RECORD)
+        recorder.save(inputPath, glfwGetTime());
+    if (inputMode == InputMode::REPLAY) {
+        frameStats.report("Reproduccion");
+        jobs->reportUtilization();
+        std::printf("Memoria por frame (pico de arena %zu KB, %llu desbordes al heap):\n",
+                    FrameArena::peakBytes() / 1024, (unsigned long long)FrameArena::overflowCount());
+        simAllocations.report();
+        renderAllocations.report();
+        stream.report();
+        particles.report();
+        occlusion.report();
+        lightClusters.report();
+        dynamicResolution.report();
+        shadows.report();
+        terrain.report();
+        terrainRenderer.report();
+        grass.report();
+        grassRenderer.report();
+        renderGraph.dump();
+        registry.report();
+        animationScheduler.report();
+        if (!csvPath.empty())
+            frameStats.writeCsv(csvPath);
+    }
+}
+
+// Avanza un tick: sistemas de entidades, ataque y partículas, y escribe lo necesario para
+// dibujar en el snapshot
+void updateSimulation(RenderSnapshot& snapshot)
+{
+    // --- JUGADORES ---
+    // Movimiento relativo al personaje, no a la cámara (Estilo Resident Evil clásico)
+    registry.parallelEach<PlayerControl, Transform>(jobs.get(), 256, [](Entity, PlayerControl& control, Transform& transform) {
+        float moveSpeed = control.moveSpeed * deltaTime;
+        float rotSpeed  = control.turnSpeed * deltaTime;
+        glm::vec3 forward(sin(glm::radians(transform.yaw)), 0.0f, cos(glm::radians(transform.yaw)));
+        if (input.pressed(INPUT_KEY_W))
+            transform.position += forward * moveSpeed;
+        if (input.pressed(INPUT_KEY_S))
+            transform.position -= forward * moveSpeed;
+        if (input.pressed(INPUT_KEY_A))
+            transform.yaw += rotSpeed;
+        if (input.pressed(INPUT_KEY_D))
+            transform.yaw -= rotSpeed;
+        transform.position.y = terrain.height(transform.position.x, transform.position.z);
+        control.moving = input.pressed(INPUT_KEY_W) || input.pressed(INPUT_KEY_S);
+    });
+
+    // Chunks del terreno alrededor del jugador (se arman en los workers). El cuadro de las
+    // sombras sigue al jugador en saltos de un chunk para no invalidar el mapa estático a cada paso.
+    const glm::vec3& playerPos = registry.get<Transform>(player).position;
+    float shadowStep = terrain.chunkSize();
+    snapshot.shadowCenter = glm::vec3(std::floor(playerPos.x / shadowStep + 0.5f) * shadowStep, 0.0f,
+                                      std::floor(playerPos.z / shadowStep + 0.5f) * shadowStep);
+    terrain.setShadowBox(snapshot.shadowCenter, shadowSettings.halfExtent);
+    terrain.update(playerPos, simFrameIndex, renderFrameIndex.load(), jobs.get());
+
+    // Disparos (secuencial: todos comparten el ProjectilePool)
+    registry.each<Weapon, Transform>([](Entity, Weapon& weapon, Transform& transform) {
+        weapon.cooldown -= deltaTime;
+        if (input.pressed(INPUT_KEY_SPACE) && weapon.cooldown <= 0.0f) {
+            weapon.cooldown = weapon.interval;
+            fireAttack(transform, weapon);
+        }
+    });
+
+    registry.each<FollowTarget, Transform>([](Entity, FollowTarget& follow, Transform& transform) {
+        if (const Transform* target = registry.tryGet<Transform>(follow.target))
+            transform.position = target->position;
+    });
+
+    // --- CÁMARA ORBITAL ---
+    // La cámara depende del mouse (angleAround) en lugar de la orientación del objetivo
+    glm::vec3 targetPos(0.0f);
+    registry.each<OrbitCamera>([&](Entity, OrbitCamera& orbit) {
+        const Transform* target = registry.tryGet<Transform>(orbit.target);
+        if (!target)
+            return;
+        // Calculamos posición de la cámara rotando alrededor del objetivo
+        glm::vec3 desired;
+        desired.x = target->position.x + sin(glm::radians(orbit.angleAround)) * orbit.distance;
+        desired.z = target->position.z + cos(glm::radians(orbit.angleAround)) * orbit.distance;
+        desired.y = target->position.y + orbit.height;
+        desired.y = std::max(desired.y, terrain.height(desired.x, desired.z) + 0.5f); // Sin atravesar cerros
 
         // Suavizado
-        cameraPos = glm::mix(cameraPos, targetCameraPos, 10.0f * deltaTime);
+        orbit.position = glm::mix(orbit.position, desired, orbit.smoothing * deltaTime);
+        targetPos = target->position;
+    });
+    const OrbitCamera& view = registry.get<OrbitCamera>(camera);
+
+    snapshot.frameIndex = ++simFrameIndex;
+    simTime += deltaTime;
+    snapshot.time = (float)simTime;
+    // Proporción de la ventana real (la escala de resolución es la misma en los dos ejes)
+    int width = framebufferWidth.load(), height = framebufferHeight.load();
+    if (width > 0 && height > 0)
+        aspectRatio = (float)width / (float)height;
+    snapshot.projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    snapshot.view = glm::lookAt(view.position, targetPos + glm::vec3(0.0f, 1.5f, 0.0f), cameraUp);
+    snapshot.cameraPos = view.position;
+    const glm::mat4 viewProjection = snapshot.projection * snapshot.view;
 
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 view = glm::lookAt(cameraPos, gokuPos + glm::vec3(0.0f, 1.5f, 0.0f), cameraUp);
+    // --- ANIMACIÓN ---
+    // El clip sigue al estado del jugador; el scheduler decide a quién evaluarle la pose
+    registry.each<PlayerControl, Animator>([](Entity, PlayerControl& control, Animator& animator) {
+        const CompressedAnimationClip* wanted = control.moving && runClip ? runClip : (idleClip ? idleClip : runClip);
+        if (animator.clip != wanted) {
+            animator.setClip(wanted);
+            animator.time = 0.0f;
+        }
+    });
+    animationScheduler.update(registry, deltaTime, view.position, snapshot.projection, viewProjection, jobs.get());
 
-        // --- RENDERIZADO DEL CIELO (SKYBOX/DOME) ---
-        // Esto obliga a dibujar la esfera por ambos lados.
-        glDisable(GL_CULL_FACE); 
+    // --- TRANSFORMACIONES ---
+    // Cada entidad con nodo le pasa su Transform; el SceneGraph sólo recalcula lo que cambió
+    registry.each<SceneNode, Transform>([](Entity, SceneNode& node, Transform& transform) {
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), transform.position);
+        local = glm::rotate(local, glm::radians(transform.yaw), glm::vec3(0.0f, 1.0f, 0.0f));
+        sceneGraph.setLocal(node.node, local);
+    });
+    sceneGraph.update();
 
-        ourShader.use();
-        ourShader.setMat4("projection", projection);
-        ourShader.setMat4("view", view);
-        
-        glm::mat4 modelSky = glm::mat4(1.0f);
-        modelSky = glm::translate(modelSky, gokuPos); 
-        ourShader.setMat4("model", modelSky);
-        
-        // Poner la luz muy alta
-        ourShader.setVec3("lightPos", glm::vec3(0.0f, 200.0f, 0.0f)); 
+    // --- VISIBILIDAD ---
+    // Los oclusores se rasterizan en la CPU (un tile por worker); después cada objeto se
+    // prueba primero contra el frustum y luego contra esa profundidad
+    const Frustum frustum = Frustum::fromMatrix(viewProjection);
+    occlusion.beginFrame(viewProjection);
+    registry.each<Occluder, Transform>([](Entity, Occluder& occluder, Transform& transform) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.position);
+        model = glm::rotate(model, glm::radians(transform.yaw), glm::vec3(0.0f, 1.0f, 0.0f));
+        occlusion.addOccluder(*occluder.mesh, model);
+    });
+    // Los cerros cercanos también tapan (oclusores conservadores por chunk, ver Terrain.h)
+    terrain.addOccluders(occlusion, frustum, view.position, 48.0f);
+    occlusion.rasterize(jobs.get());
+    // Caja de un personaje parado en 'position' (Goku y la multitud miden lo mismo)
+    auto characterVisible = [&frustum](const glm::vec3& position) {
+        const glm::vec3 halfWidth(0.6f, 0.0f, 0.6f), height(0.0f, 2.0f, 0.0f);
+        return frustum.intersectsSphere(position + height * 0.5f, 1.2f)
+            && occlusion.isVisible(position - halfWidth, position + halfWidth + height);
+    };
+    // Lo que proyecta sombra se prueba contra el cuadro de las sombras visto desde el sol
+    // (las mismas matrices que usará ShadowMap::setLight), sin oclusión
+    glm::mat4 lightView, lightProjection;
+    ShadowMap::lightMatrices(SUN_DIRECTION, snapshot.shadowCenter, shadowSettings.halfExtent, lightView, lightProjection);
+    const Frustum shadowFrustum = Frustum::fromMatrix(lightProjection * lightView);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, skyTexture);
-        ourShader.setInt("texture_diffuse1", 0);
-        
-        skyDome.Draw();
-
-        // CAMBIO: Volver a activar el Culling normal para Goku y el resto
-        glEnable(GL_CULL_FACE); 
-        glCullFace(GL_BACK); // Aseguramos que vuelva al estándar
-
-        // --- RENDERIZADO DE GOKU ---
-        bool isMoving = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || 
-                        glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
-        Model* currentModel = isMoving ? &runModel : &idleModel;
-
-        // Matriz de Goku
-        glm::mat4 modelBase = glm::mat4(1.0f);
-        modelBase = glm::translate(modelBase, gokuPos); 
-        modelBase = glm::rotate(modelBase, glm::radians(gokuAngle), glm::vec3(0.0f, 1.0f, 0.0f)); 
-        modelBase = glm::rotate(modelBase, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)); 
-        modelBase = glm::translate(modelBase, glm::vec3(0.0f, -1.0f, 0.0f));
+    // --- GOKU ---
+    const Transform& gokuTransform = registry.get<Transform>(player);
+    snapshot.gokuPos = gokuTransform.position;
+    snapshot.gokuMoving = registry.get<PlayerControl>(player).moving;
+    snapshot.gokuVisible = characterVisible(gokuTransform.position);
+    snapshot.gokuModel = sceneGraph.world(gokuMeshNode);
+    snapshot.skyModel = sceneGraph.world(registry.get<SceneNode>(sky).node);
+
+    // --- TERRENO ---
+    if (snapshot.terrainChunks.capacity() < (size_t)TERRAIN_MAX_CHUNKS) {
+        snapshot.terrainChunks.reserve(TERRAIN_MAX_CHUNKS);
+        snapshot.terrainShadowChunks.reserve(TERRAIN_MAX_CHUNKS);
+    }
+    terrain.buildDraws(view.position, frustum, snapshot.terrainChunks, snapshot.terrainShadowChunks);
+    snapshot.staticGeometryVersion = terrain.version();
+
+    // --- PASTO --- (sólo los chunks visibles y cercanos, con menos hojas a más distancia)
+    if (snapshot.grassChunks.capacity() < (size_t)TERRAIN_MAX_CHUNKS)
+        snapshot.grassChunks.reserve(TERRAIN_MAX_CHUNKS);
+    grass.buildDraws(terrain, snapshot.terrainChunks, view.position, occlusion, snapshot.grassChunks);
+
+    // --- MULTITUD ---
+    if (snapshot.crowdInstances.capacity() < (size_t)CROWD_SIZE) {
+        snapshot.crowdInstances.reserve(CROWD_SIZE);
+        snapshot.crowdShadowInstances.reserve(CROWD_SIZE);
+    }
+    snapshot.crowdInstances.clear();
+    snapshot.crowdShadowInstances.clear();
+    registry.each<CrowdMember, Transform>([&](Entity, CrowdMember& member, Transform& transform) {
+        VatInstance instance;
+        instance.model = member.model;
+        instance.anim = member.anim;
+        if (shadowFrustum.intersectsSphere(transform.position + glm::vec3(0.0f, 1.0f, 0.0f), 1.2f))
+            snapshot.crowdShadowInstances.push_back(instance);
+        if (characterVisible(transform.position))
+            snapshot.crowdInstances.push_back(instance);
+    });
 
+    // --- ATAQUE ---
+    // Todas las bolas avanzan juntas (Bézier en lote, velocidad constante por longitud de arco)
+    projectiles.update(deltaTime);
+    projectiles.writeModels(snapshot.projectileModels, 0.5f);
+    std::vector<glm::mat4>& models = snapshot.projectileModels;
+    // Sombras: las que caen en el cuadro, antes de quitar las que no ve la cámara
+    if (snapshot.projectileShadowModels.capacity() < projectiles.capacity())
+        snapshot.projectileShadowModels.reserve(projectiles.capacity());
+    snapshot.projectileShadowModels.clear();
+    for (const glm::mat4& model : models)
+        if (shadowFrustum.intersectsSphere(glm::vec3(model[3]), 0.2f))
+            snapshot.projectileShadowModels.push_back(model);
+    // Sólo se dibujan las bolas visibles (las estelas se emiten igual, abajo)
+    models.erase(std::remove_if(models.begin(), models.end(), [&frustum](const glm::mat4& model) {
+        glm::vec3 center(model[3]);
+        const glm::vec3 extent(0.2f);
+        return !frustum.intersectsSphere(center, 0.2f) || !occlusion.isVisible(center - extent, center + extent);
+    }), models.end());
+
+    // Estelas: el total de partículas por segundo se reparte entre las bolas vivas
+    size_t live = projectiles.size();
+    if (live > 0) {
+        unsigned int perProjectile = (unsigned int)(trailSettings.rate * deltaTime * particles.emissionScaleFactor() / live) + 1;
+        for (size_t i = 0; i < live; i++)
+            particles.emitSegment(trailSettings, projectiles.previousPosition(i), projectiles.position(i), perProjectile);
+    }
+
+    // --- LUCES ---
+    // Cada bola ilumina lo que tiene cerca (aunque la bola misma no se vea)
+    pointLights.clear();
+    for (size_t i = 0; i < live && i < (size_t)MAX_CLUSTER_LIGHTS; i++) {
+        PointLight light;
+        light.position = projectiles.position(i);
+        light.radius = 6.0f;
+        light.color = trailSettings.color;
+        light.intensity = 2.0f;
+        pointLights.push_back(light);
+    }
+    lightClusters.build(pointLights.data(), pointLights.size(), snapshot.view, snapshot.projection,
+                        CLUSTER_NEAR, CLUSTER_FAR, jobs.get(), snapshot.lightClusters);
+
+    ParticleEmitter& aura = particles.emitter(auraEmitter);
+    aura.position = gokuTransform.position;
+    aura.active = live > 0;
+
+    // Explosión donde cayó cada bola
+    ParticleEmitter& impact = particles.emitter(impactEmitter);
+    for (const glm::vec3& point : projectiles.impacts()) {
+        impact.position = point;
+        particles.burst(impact, 20000 / (unsigned int)projectiles.impacts().size());
+    }
+
+    // --- PARTÍCULAS ---
+    particles.update(deltaTime, jobs.get());
+    particles.writeInstances(snapshot.particles);
+}
+
+void renderThreadMain(GLFWwindow* window, SceneResources scene, bool vsync)
+{
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(vsync ? 1 : 0);
+    jobs->registerThread();
+
+    // Grafo del frame: las sombras, la escena HDR a la escala actual en texturas
+    // transitorias, el bloom y el escalado al backbuffer. El grafo decide framebuffers,
+    // vidas y qué texturas comparten memoria (sin intensidad de bloom, sus pases se quitan solos).
+    RenderGraph& graph = *scene.graph;
+    const RenderSnapshot* current = nullptr;
+    RenderGraphHandle backbuffer = graph.importTexture("backbuffer", 0);
+    RenderGraphHandle sceneColor = RG_INVALID_HANDLE;
+    RenderGraphHandle shadowMap = scene.shadows->addPasses(graph,
+        [&] { renderShadowCasters(*current, scene, true); },
+        [&] { renderShadowCasters(*current, scene, false); });
+    graph.addPass("escena",
+        [&](RenderGraph::Builder& pass) {
+            pass.read(shadowMap);
+            RenderGraphTextureDesc color, depth;
+            color.format = RG_FORMAT_RGBA16F;
+            depth.format = RG_FORMAT_DEPTH24;
+            sceneColor = pass.create("sceneColor", color);
+            pass.write(sceneColor);
+            pass.write(pass.create("sceneDepth", depth));
+        },
+        [&](const RenderGraphContext& context) {
+            scene.shadows->bind(context.texture(shadowMap));
+            scene.resolution->beginScene(context.width, context.height);
+            renderScene(*current, scene);
+            scene.resolution->endScene();
+        });
+    RenderGraphHandle bloomResult = scene.bloom->addPasses(graph, sceneColor, *scene.resolution);
+    bool useBloom = scene.bloom->settings.intensity > 0.0f;
+    graph.addPass("escalado",
+        [&](RenderGraph::Builder& pass) {
+            pass.read(sceneColor);
+            if (useBloom)
+                pass.read(bloomResult);
+            pass.write(backbuffer);
+        },
+        [&](const RenderGraphContext& context) {
+            scene.resolution->upscale(context.texture(sceneColor), useBloom ? context.texture(bloomResult) : 0,
+                                      scene.bloom->settings.intensity);
+        });
+    bool dumped = false;
+
+    while (renderRunning.load()) {
+        // Esperamos un snapshot nuevo; si no hay, volver a dibujar el mismo no aporta nada
+        if (!snapshots.acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+        renderFrameIndex.store(snapshots.front().frameIndex);
+
+        FrameArena::beginFrame();
+        renderAllocations.beginFrame();
+        scene.stream->beginFrame();
+        // Minimizada no hay nada que dibujar; al cambiar de tamaño se recompila el grafo
+        int width = framebufferWidth.load(), height = framebufferHeight.load();
+        if (width > 0 && height > 0) {
+            if (graph.needsCompile(width, height)) {
+                graph.compile(width, height);
+                if (!dumped)
+                    graph.dump();
+                dumped = true;
+            }
+            current = &snapshots.front();
+            scene.shadows->setLight(SUN_DIRECTION, current->shadowCenter, current->staticGeometryVersion);
+            graph.execute();
+        }
+        scene.stream->endFrame();
+        renderAllocations.endFrame();
+
+        glfwSwapBuffers(window);
+        // Borra lo que se soltó en frames que la GPU ya terminó
+        GpuResources::endFrame();
+    }
+    // Al cerrar ya no hay frames en vuelo: lo pendiente se borra sin esperar fences
+    GpuResources::flush();
+    glfwMakeContextCurrent(NULL);
+}
+
+void renderScene(const RenderSnapshot& snapshot, SceneResources& scene)
+{
+    Shader& ourShader = *scene.ourShader;
+    Shader& outlineShader = *scene.outlineShader;
+    StreamBuffer& stream = *scene.stream;
+
+    // Datos por frame y por draw: se escriben en el StreamBuffer y se enlazan como bloques
+    // de uniforms en vez de hacer un glUniform por valor
+    FrameUniforms frame;
+    frame.projection = snapshot.projection;
+    frame.view = snapshot.view;
+    frame.viewPos = glm::vec4(snapshot.cameraPos, 1.0f);
+    const LightClusterData& clusters = snapshot.lightClusters;
+    frame.clusterGrid = glm::vec4((float)CLUSTER_TILES_X, (float)CLUSTER_TILES_Y, (float)CLUSTER_SLICES, (float)clusters.lights.size());
+    frame.clusterDepth = glm::vec4(clusters.sliceScale(), clusters.sliceBias(), 0.0f, 0.0f);
+    frame.lightSpace = scene.shadows->lightSpace();
+    stream.bindUniform(UBO_FRAME, stream.pushUniform(frame));
+
+    auto setObject = [&stream](const glm::mat4& model, const glm::vec3& lightPos) {
+        ObjectUniforms object;
+        object.model = model;
+        object.lightPos = glm::vec4(lightPos, 0.0f);
+        stream.bindUniform(UBO_OBJECT, stream.pushUniform(object));
+    };
+
+    scene.lightBuffers->upload(clusters);
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // --- RENDERIZADO DEL CIELO (SKYBOX/DOME) ---
+    // Esto obliga a dibujar la esfera por ambos lados.
+    glDisable(GL_CULL_FACE); 
+
+    ourShader.use();
+    
+    // Poner la luz muy alta
+    setObject(snapshot.skyModel, glm::vec3(0.0f, 200.0f, 0.0f));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene.skyTexture.id());
+    ourShader.setInt("texture_diffuse1", 0);
+    
+    scene.skyDome->Draw();
+
+    // CAMBIO: Volver a activar el Culling normal para Goku y el resto
+    glEnable(GL_CULL_FACE); 
+    glCullFace(GL_BACK); // Aseguramos que vuelva al estándar
+
+    // --- RENDERIZADO DE GOKU ---
+    Model* currentModel = snapshot.gokuMoving ? scene.runModel : scene.idleModel;
+    const glm::vec3& sunDirection = SUN_DIRECTION;
+
+    auto setMeshTransform = [&](const glm::mat4& world) { setObject(world, sunDirection); };
+    if (snapshot.gokuVisible) {
         // Outline
         glCullFace(GL_FRONT); 
         outlineShader.use();
-        outlineShader.setMat4("projection", projection);
-        outlineShader.setMat4("view", view);
-        glm::mat4 modelOutline = glm::scale(modelBase, glm::vec3(1.02f, 1.02f, 1.02f)); 
-        outlineShader.setMat4("model", modelOutline);
-        currentModel->Draw(outlineShader);
+        glm::mat4 modelOutline = glm::scale(snapshot.gokuModel, glm::vec3(1.02f, 1.02f, 1.02f)); 
+        currentModel->Draw(outlineShader, modelOutline, setMeshTransform);
 
         // Normal
         glCullFace(GL_BACK); 
         ourShader.use();
-        ourShader.setMat4("projection", projection);
-        ourShader.setMat4("view", view);
-        // Luz tipo SOL (Dirección fija desde arriba a la derecha)
-        ourShader.setVec3("lightPos", glm::vec3(50.0f, 100.0f, 50.0f)); 
-        ourShader.setVec3("viewPos", cameraPos);
-        
-        glm::mat4 modelNormal = glm::scale(modelBase, glm::vec3(1.0f, 1.0f, 1.0f));
-        ourShader.setMat4("model", modelNormal);
-        currentModel->Draw(ourShader);
-
-        // --- ATAQUE ---
-        if (isAttacking) {
-            attackTime += deltaTime * 1.5f;
-            glm::vec3 p0 = gokuPos + glm::vec3(0.0f, 1.5f, 0.0f);
-            float dist = 10.0f;
-            glm::vec3 p3;
-            // Dispara hacia donde mira GOKU, no la cámara
-            p3.x = gokuPos.x + sin(glm::radians(gokuAngle)) * dist;
-            p3.z = gokuPos.z + cos(glm::radians(gokuAngle)) * dist;
-            p3.y = gokuPos.y + 0.5f;
-            glm::vec3 p1 = p0 + glm::vec3(0.0f, 3.0f, 0.0f);
-            glm::vec3 p2 = p3 + glm::vec3(0.0f, 2.0f, 0.0f);
-
-            if (attackTime <= 1.0f) {
-                spherePos = calculateBezier(attackTime, p0, p1, p2, p3);
-                glm::mat4 modelBall = glm::mat4(1.0f);
-                modelBall = glm::translate(modelBall, spherePos);
-                modelBall = glm::scale(modelBall, glm::vec3(0.5f, 0.5f, 0.5f)); 
-                ourShader.setMat4("model", modelBall);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, poderTexture); 
-                energyBall.Draw();
-            } else {
-                isAttacking = false;
-            }
-        }
+        currentModel->Draw(ourShader, snapshot.gokuModel, setMeshTransform);
+    }
+
+    // --- MULTITUD ---
+    // Un draw instanciado por submalla con las instancias visibles; la animación la calcula
+    // el vertex shader
+    size_t crowdCount = snapshot.crowdInstances.size();
+    StreamAllocation crowdInstances;
+    if (scene.crowd->isLoaded() && crowdCount > 0)
+        crowdInstances = stream.allocateVertices(crowdCount * sizeof(VatInstance));
+    if (crowdInstances) {
+        std::memcpy(crowdInstances.data, snapshot.crowdInstances.data(), crowdCount * sizeof(VatInstance));
+        stream.commit();
+        scene.crowdShader->use();
+        setObject(glm::mat4(1.0f), sunDirection);
+        scene.crowd->draw(*scene.crowdShader, snapshot.time, stream.id(), crowdInstances.offset, (GLsizei)crowdCount);
+        ourShader.use();
+    }
 
-        // --- SUELO ---
-        glDisable(GL_CULL_FACE); 
-        glm::mat4 modelPlane = glm::mat4(1.0f);
-        modelPlane = glm::translate(modelPlane, glm::vec3(0.0f, -0.01f, 0.0f)); 
-        ourShader.setMat4("model", modelPlane);
+    // --- ATAQUE ---
+    // Todas las bolas en un solo draw instanciado; las matrices van al StreamBuffer
+    size_t projectileCount = snapshot.projectileModels.size();
+    StreamAllocation instances;
+    if (projectileCount > 0)
+        instances = stream.allocateVertices(projectileCount * sizeof(glm::mat4));
+    if (instances) {
+        std::memcpy(instances.data, snapshot.projectileModels.data(), projectileCount * sizeof(glm::mat4));
+        stream.commit();
+        Shader& instancedShader = *scene.instancedShader;
+        instancedShader.use();
+        instancedShader.setInt("texture_diffuse1", 0);
+        setObject(glm::mat4(1.0f), sunDirection);
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, floorTexture); 
-        glBindVertexArray(planeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
-        glEnable(GL_CULL_FACE);
+        glBindTexture(GL_TEXTURE_2D, scene.poderTexture.id());
+        scene.energyBall->DrawInstanced(stream.id(), instances.offset, (GLsizei)projectileCount);
+        ourShader.use();
+    }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    // --- SUELO ---
+    // Un draw por chunk visible con su LOD; la textura de pasto se repite cada 2 m
+    Shader& terrainShader = *scene.terrainShader;
+    terrainShader.use();
+    terrainShader.setInt("texture_diffuse1", 0);
+    setObject(glm::mat4(1.0f), sunDirection);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene.floorTexture.id());
+    scene.terrainRenderer->draw(terrainShader, terrain, snapshot.terrainChunks.data(), snapshot.terrainChunks.size());
+
+    // --- PASTO --- (un draw instanciado por chunk cercano, con la misma textura del suelo)
+    Shader& grassShader = *scene.grassShader;
+    grassShader.use();
+    grassShader.setInt("texture_diffuse1", 0);
+    scene.grassRenderer->draw(grassShader, terrain, snapshot.grassChunks.data(), snapshot.grassChunks.size(), snapshot.time);
+
+    // --- PARTÍCULAS (transparentes, al final) ---
+    scene.particleRenderer->draw(snapshot.particles.data(), snapshot.particles.size(), stream);
+}
+
+// Oclusores del mapa de sombras vistos desde el sol: lo estático (sólo cuando cambia) o lo
+// que se mueve (cada frame, encima de la copia del estático)
+void renderShadowCasters(const RenderSnapshot& snapshot, SceneResources& scene, bool staticCasters)
+{
+    StreamBuffer& stream = *scene.stream;
+    FrameUniforms frame = {};
+    frame.projection = scene.shadows->lightProjection();
+    frame.view = scene.shadows->lightView();
+    stream.bindUniform(UBO_FRAME, stream.pushUniform(frame));
+
+    auto setObject = [&stream](const glm::mat4& model) {
+        ObjectUniforms object;
+        object.model = model;
+        object.lightPos = glm::vec4(SUN_DIRECTION, 0.0f);
+        stream.bindUniform(UBO_OBJECT, stream.pushUniform(object));
+    };
+
+    if (staticCasters) {
+        // --- SUELO --- (los chunks dentro del cuadro de las sombras, en LOD 0)
+        scene.terrainDepthShader->use();
+        setObject(glm::mat4(1.0f));
+        scene.terrainRenderer->draw(*scene.terrainDepthShader, terrain, snapshot.terrainShadowChunks.data(),
+                                    snapshot.terrainShadowChunks.size());
+        return;
+    }
+
+    // --- GOKU --- (aunque la cámara no lo vea, su sombra puede caer en pantalla)
+    Model* currentModel = snapshot.gokuMoving ? scene.runModel : scene.idleModel;
+    scene.depthShader->use();
+    currentModel->Draw(*scene.depthShader, snapshot.gokuModel, setObject);
+
+    // --- MULTITUD --- (los que caen en el cuadro de las sombras, aunque la cámara no los vea)
+    size_t crowdCount = snapshot.crowdShadowInstances.size();
+    StreamAllocation crowdInstances;
+    if (scene.crowd->isLoaded() && crowdCount > 0)
+        crowdInstances = stream.allocateVertices(crowdCount * sizeof(VatInstance));
+    if (crowdInstances) {
+        std::memcpy(crowdInstances.data, snapshot.crowdShadowInstances.data(), crowdCount * sizeof(VatInstance));
+        stream.commit();
+        scene.depthCrowdShader->use();
+        setObject(glm::mat4(1.0f));
+        scene.crowd->draw(*scene.depthCrowdShader, snapshot.time, stream.id(), crowdInstances.offset, (GLsizei)crowdCount);
+    }
+
+    // --- ATAQUE ---
+    size_t projectileCount = snapshot.projectileShadowModels.size();
+    StreamAllocation instances;
+    if (projectileCount > 0)
+        instances = stream.allocateVertices(projectileCount * sizeof(glm::mat4));
+    if (instances) {
+        std::memcpy(instances.data, snapshot.projectileShadowModels.data(), projectileCount * sizeof(glm::mat4));
+        stream.commit();
+        scene.depthInstancedShader->use();
+        setObject(glm::mat4(1.0f));
+        scene.energyBall->DrawInstanced(stream.id(), instances.offset, (GLsizei)projectileCount);
     }
-    glfwTerminate();
-    return 0;
 }
 
 // Control del Mouse para Rotar Cámara
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
 {
+    // Durante la reproducción el mouse real se ignora
+    if (inputMode == InputMode::REPLAY)
+        return;
+
     float xpos = static_cast<float>(xposIn);
+    if (inputMode == InputMode::RECORD)
+        recorder.recordCursor(glfwGetTime(), xpos);
+    applyCursorX(xpos);
+}
 
+void applyCursorX(float xpos)
+{
     if (firstMouse) {
         lastX = xpos;
         firstMouse = false;
@@ -270,7 +1067,7 @@ void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
 
     // Sensibilidad del mouse
     float sensitivity = 0.5f; 
-    cameraAngleAround -= xoffset * sensitivity;
+    registry.get<OrbitCamera>(camera).angleAround -= xoffset * sensitivity;
 }
 
 void processInput(GLFWwindow *window)
@@ -278,28 +1075,32 @@ void processInput(GLFWwindow *window)
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    float moveSpeed = 4.0f * deltaTime;
-    float rotSpeed  = 90.0f * deltaTime;
+    // El movimiento y los disparos los aplican los sistemas de updateSimulation
+}
 
-    // Movimiento: Se mueve relativo a GOKU, no a la cámara (Estilo Resident Evil clásico)
-    // Si quisieras que se mueva relativo a la cámara, tendrías que usar cameraAngleAround aquí.
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-        gokuPos.x += sin(glm::radians(gokuAngle)) * moveSpeed;
-        gokuPos.z += cos(glm::radians(gokuAngle)) * moveSpeed;
-    }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-        gokuPos.x -= sin(glm::radians(gokuAngle)) * moveSpeed;
-        gokuPos.z -= cos(glm::radians(gokuAngle)) * moveSpeed;
-    }
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        gokuAngle += rotSpeed;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        gokuAngle -= rotSpeed;
-
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !isAttacking) {
-        isAttacking = true;
-        attackTime = 0.0f;
-    }
+// Lanza una bola de energía hacia donde mira el tirador, no la cámara. Cada disparo se abre
+// un poco a los lados (patrón fijo, así la reproducción es determinista).
+void fireAttack(const Transform& transform, Weapon& weapon)
+{
+    static const float spread[] = { 0.0f, -6.0f, 6.0f, -12.0f, 12.0f };
+    float angle = transform.yaw + spread[weapon.shotsFired++ % 5];
+
+    const glm::vec3& origin = transform.position;
+    glm::vec3 p0 = origin + glm::vec3(0.0f, 1.5f, 0.0f);
+    glm::vec3 p3;
+    p3.x = origin.x + sin(glm::radians(angle)) * weapon.range;
+    p3.z = origin.z + cos(glm::radians(angle)) * weapon.range;
+    p3.y = origin.y + 0.5f;
+    glm::vec3 p1 = p0 + glm::vec3(0.0f, 3.0f, 0.0f);
+    glm::vec3 p2 = p3 + glm::vec3(0.0f, 2.0f, 0.0f);
+
+    // Misma duración que el ataque original (t avanzaba 1.5 por segundo)
+    projectiles.spawn(p0, p1, p2, p3, weapon.flightTime);
+}
+// Corre en el hilo principal (sin contexto): el hilo de render aplica el glViewport
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    framebufferWidth.store(width);
+    framebufferHeight.store(height);
 }
-void framebuffer_size_callback(GLFWwindow* window, int width, int height) { glViewport(0, 0, width, height); }
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {}
\ No newline at end of file
@@ -1,8 +0,0 @@
-#version 330 core
-out vec4 FragColor;
-
-void main()
-{
-    // Color RGBA: Negro totalmente opaco
-    FragColor = vec4(0.0, 0.0, 0.0, 1.0);
-}
\ No newline at end of file
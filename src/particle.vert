@@ -0,0 +1,28 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;        // Esquina del quad (-1..1)
+layout (location = 1) in vec4 aPositionSize;  // Por instancia: xyz = centro, w = tamaño
+layout (location = 2) in vec4 aColor;         // Por instancia: rgb = color, a = vida restante (1 -> 0)
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+};
+
+out vec2 Corner;
+out vec4 Color;
+
+void main()
+{
+    // Billboard: los ejes derecha/arriba de la cámara son las filas de la matriz view
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up    = vec3(view[0][1], view[1][1], view[2][1]);
+
+    // Se encogen al morir
+    float size = aPositionSize.w * (0.4 + 0.6 * aColor.a);
+    vec3 worldPos = aPositionSize.xyz + (right * aCorner.x + up * aCorner.y) * size;
+
+    Corner = aCorner;
+    Color = aColor;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
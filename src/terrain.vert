@@ -0,0 +1,58 @@
+#version 330 core
+// Chunk de terreno (ver Terrain.h / TerrainRenderer.h). Usa basic.frag como fragment shader.
+layout (location = 0) in vec2 aGrid;  // Coordenada entera en la rejilla del LOD
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    mat4 lightSpace;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 model;
+    vec4 lightPos;
+};
+
+uniform sampler2D heightMap;  // Alturas del chunk con 1 texel de margen por lado
+uniform vec2 chunkOrigin;     // Esquina mínima en x/z
+uniform float chunkSize;
+uniform float gridDim;        // Quads por lado del LOD actual
+uniform vec2 morphRange;      // Distancia donde empieza y termina la transición al LOD siguiente
+
+// unit: posición en el chunk de 0 a 1
+float sampleHeight(vec2 unit)
+{
+    float size = float(textureSize(heightMap, 0).x);
+    return textureLod(heightMap, (unit * (size - 3.0) + 1.5) / size, 0.0).r;
+}
+
+void main()
+{
+    vec2 unit = aGrid / gridDim;
+    vec3 world = vec3(chunkOrigin.x + unit.x * chunkSize, sampleHeight(unit), chunkOrigin.y + unit.y * chunkSize);
+
+    // Los vértices impares se acercan a la mitad de su arista (la malla del LOD siguiente)
+    float k = clamp((distance(world, viewPos.xyz) - morphRange.x) / (morphRange.y - morphRange.x), 0.0, 1.0);
+    vec2 grid = aGrid - fract(aGrid * 0.5) * 2.0 * k;
+    unit = grid / gridDim;
+    world = vec3(chunkOrigin.x + unit.x * chunkSize, sampleHeight(unit), chunkOrigin.y + unit.y * chunkSize);
+
+    // Normal por diferencias centrales con el paso del LOD 0 (igual en todos los LOD)
+    float size = float(textureSize(heightMap, 0).x);
+    float step = 1.0 / (size - 3.0);
+    float spacing = chunkSize * step;
+    float dx = sampleHeight(unit + vec2(step, 0.0)) - sampleHeight(unit - vec2(step, 0.0));
+    float dz = sampleHeight(unit + vec2(0.0, step)) - sampleHeight(unit - vec2(0.0, step));
+
+    FragPos = world;
+    Normal = normalize(vec3(-dx, 2.0 * spacing, -dz));
+    TexCoords = world.xz * 0.5;
+    gl_Position = projection * view * vec4(world, 1.0);
+}
@@ -0,0 +1,41 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D sceneColor;  // HDR
+uniform sampler2D bloom;       // Nivel 0 de Bloom.h (misma parte usada que la escena)
+uniform vec2 uvScale;    // Parte de la textura que se dibujó este frame
+uniform vec2 texelSize;  // 1 / tamaño de la textura
+uniform float sharpness;
+uniform float bloomIntensity;
+
+// Lineal hasta 'knee' (la escena LDR queda igual) y de ahí se acerca a 1 sin saturar
+vec3 tonemap(vec3 c)
+{
+    const float knee = 0.8;
+    vec3 over = max(c - knee, 0.0);
+    return min(c, vec3(knee)) + (1.0 - knee) * (1.0 - exp(-over / (1.0 - knee)));
+}
+
+void main()
+{
+    // Sin salir de la parte dibujada (el resto de la textura tiene frames viejos)
+    vec2 lo = texelSize * 0.5;
+    vec2 hi = uvScale - texelSize * 0.5;
+    vec2 uv = clamp(TexCoord * uvScale, lo, hi);
+
+    // El bloom es de baja frecuencia: una muestra alcanza para los 5 taps
+    vec3 glow = texture(bloom, uv).rgb * bloomIntensity;
+    vec3 center = tonemap(texture(sceneColor, uv).rgb + glow);
+    vec3 left   = tonemap(texture(sceneColor, clamp(uv - vec2(texelSize.x, 0.0), lo, hi)).rgb + glow);
+    vec3 right  = tonemap(texture(sceneColor, clamp(uv + vec2(texelSize.x, 0.0), lo, hi)).rgb + glow);
+    vec3 down   = tonemap(texture(sceneColor, clamp(uv - vec2(0.0, texelSize.y), lo, hi)).rgb + glow);
+    vec3 up     = tonemap(texture(sceneColor, clamp(uv + vec2(0.0, texelSize.y), lo, hi)).rgb + glow);
+
+    // Máscara de enfoque en cruz, limitada al rango de los vecinos para que no haya halos
+    vec3 sharpened = center + sharpness * (4.0 * center - left - right - down - up) * 0.25;
+    vec3 lowest  = min(center, min(min(left, right), min(down, up)));
+    vec3 highest = max(center, max(max(left, right), max(down, up)));
+    FragColor = vec4(clamp(sharpened, lowest, highest), 1.0);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+// Triángulo que cubre la pantalla, sin búfer de vértices (sale de gl_VertexID)
+out vec2 TexCoord;
+
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoord = corner;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,293 @@
+// Herramienta offline: hornea las animaciones de un FBX en texturas de animación de
+// vértices (ver src/VatFormat.h).
+//
+//   vat_bake entrada.fbx salida.vat [--fps 30]
+//
+// Cada aiAnimation del archivo se vuelve un clip: se muestrea a 'fps' frames por segundo,
+// se evalúa la jerarquía de aiNode con sus canales y se aplica el skinning de los aiBone.
+// Un archivo sin animaciones produce un clip "pose" de un solo frame (la pose del archivo).
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <glm/glm.hpp>
+
+#include "../src/AnimationClip.h"
+#include "../src/VatFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+
+static glm::mat4 toGlm(const aiMatrix4x4& m) {
+    // aiMatrix4x4 está por filas y glm por columnas
+    return glm::mat4(m.a1, m.b1, m.c1, m.d1,
+                     m.a2, m.b2, m.c2, m.d2,
+                     m.a3, m.b3, m.c3, m.d3,
+                     m.a4, m.b4, m.c4, m.d4);
+}
+
+class Baker {
+public:
+    explicit Baker(const aiScene* scene) : scene(scene) {
+        collectMeshes(scene->mRootNode);
+    }
+
+    // Geometría fija (UVs, índices, submallas) en el mismo orden que Model::processNode
+    void writeTopology(VatData& data) const {
+        for (const MeshRef& ref : meshes) {
+            const aiMesh* mesh = scene->mMeshes[ref.mesh];
+            VatSubmesh submesh;
+            submesh.firstIndex = (uint32_t)data.indices.size();
+            for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+                const aiFace& face = mesh->mFaces[f];
+                for (unsigned int j = 0; j < face.mNumIndices; j++)
+                    data.indices.push_back(ref.firstVertex + face.mIndices[j]);
+            }
+            submesh.indexCount = (uint32_t)data.indices.size() - submesh.firstIndex;
+
+            const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            aiString path;
+            if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0 && material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
+                std::strncpy(submesh.diffuse, path.C_Str(), sizeof(submesh.diffuse) - 1);
+            data.submeshes.push_back(submesh);
+
+            for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+                bool hasUV = mesh->mTextureCoords[0] != nullptr;
+                data.texCoords.push_back(hasUV ? mesh->mTextureCoords[0][v].x : 0.0f);
+                data.texCoords.push_back(hasUV ? mesh->mTextureCoords[0][v].y : 0.0f);
+            }
+        }
+    }
+
+    uint32_t vertexCount() const { return totalVertices; }
+
+    // Posiciones y normales de todos los vértices con la animación en 'ticks' (nullptr = pose)
+    void evaluate(const aiAnimation* animation, double ticks, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) {
+        worlds.clear();
+        evaluateNode(scene->mRootNode, glm::mat4(1.0f), animation, ticks);
+
+        positions.assign(totalVertices, glm::vec3(0.0f));
+        normals.assign(totalVertices, glm::vec3(0.0f));
+        for (const MeshRef& ref : meshes) {
+            const aiMesh* mesh = scene->mMeshes[ref.mesh];
+            if (mesh->mNumBones == 0) {
+                // Malla rígida: la matriz de su nodo
+                glm::mat4 world = worlds[ref.node];
+                glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(world)));
+                for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+                    const aiVector3D& p = mesh->mVertices[v];
+                    positions[ref.firstVertex + v] = glm::vec3(world * glm::vec4(p.x, p.y, p.z, 1.0f));
+                    if (mesh->HasNormals()) {
+                        const aiVector3D& n = mesh->mNormals[v];
+                        normals[ref.firstVertex + v] = normalMatrix * glm::vec3(n.x, n.y, n.z);
+                    }
+                }
+                continue;
+            }
+            // Skinning: cada hueso lleva el vértice del espacio de la malla al suyo (offset)
+            // y de ahí al de la raíz con la matriz de mundo de su nodo
+            weightSums.assign(mesh->mNumVertices, 0.0f);
+            for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+                const aiBone* bone = mesh->mBones[b];
+                auto node = worlds.find(std::string(bone->mName.C_Str()));
+                glm::mat4 skin = (node != worlds.end() ? node->second : glm::mat4(1.0f)) * toGlm(bone->mOffsetMatrix);
+                glm::mat3 skinNormal = glm::mat3(skin);
+                for (unsigned int w = 0; w < bone->mNumWeights; w++) {
+                    const aiVertexWeight& weight = bone->mWeights[w];
+                    if (weight.mVertexId >= mesh->mNumVertices)
+                        continue;
+                    weightSums[weight.mVertexId] += weight.mWeight;
+                    const aiVector3D& p = mesh->mVertices[weight.mVertexId];
+                    positions[ref.firstVertex + weight.mVertexId] += weight.mWeight * glm::vec3(skin * glm::vec4(p.x, p.y, p.z, 1.0f));
+                    if (mesh->HasNormals()) {
+                        const aiVector3D& n = mesh->mNormals[weight.mVertexId];
+                        normals[ref.firstVertex + weight.mVertexId] += weight.mWeight * (skinNormal * glm::vec3(n.x, n.y, n.z));
+                    }
+                }
+            }
+            // Vértices sin pesos: se quedan rígidos con el nodo de la malla
+            glm::mat4 world = worlds[ref.node];
+            for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+                if (weightSums[v] > 0.0f)
+                    continue;
+                const aiVector3D& p = mesh->mVertices[v];
+                positions[ref.firstVertex + v] = glm::vec3(world * glm::vec4(p.x, p.y, p.z, 1.0f));
+                if (mesh->HasNormals())
+                    normals[ref.firstVertex + v] = glm::mat3(world) * glm::vec3(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z);
+            }
+        }
+        for (glm::vec3& n : normals) {
+            float length = glm::length(n);
+            n = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+
+private:
+    struct MeshRef {
+        unsigned int mesh;
+        std::string node;
+        uint32_t firstVertex;
+    };
+
+    const aiScene* scene;
+    std::vector<MeshRef> meshes;
+    uint32_t totalVertices = 0;
+    std::map<std::string, glm::mat4> worlds;
+    std::vector<float> weightSums;
+
+    void collectMeshes(const aiNode* node) {
+        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+            unsigned int mesh = node->mMeshes[i];
+            bool seen = false;
+            for (const MeshRef& ref : meshes)
+                seen = seen || ref.mesh == mesh;
+            if (seen)
+                continue;
+            meshes.push_back({ mesh, node->mName.C_Str(), totalVertices });
+            totalVertices += scene->mMeshes[mesh]->mNumVertices;
+        }
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+            collectMeshes(node->mChildren[i]);
+    }
+
+    void evaluateNode(const aiNode* node, const glm::mat4& parent, const aiAnimation* animation, double ticks) {
+        glm::mat4 local = toGlm(node->mTransformation);
+        if (animation) {
+            for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+                const aiNodeAnim* channel = animation->mChannels[c];
+                if (channel->mNodeName != node->mName)
+                    continue;
+                glm::mat4 t(1.0f), r(1.0f), s(1.0f);
+                if (channel->mNumPositionKeys > 0) {
+                    glm::vec3 p = sampleAssimpVector(channel->mPositionKeys, channel->mNumPositionKeys, ticks);
+                    t[3] = glm::vec4(p, 1.0f);
+                }
+                if (channel->mNumRotationKeys > 0)
+                    r = glm::mat4_cast(sampleAssimpRotation(channel->mRotationKeys, channel->mNumRotationKeys, ticks));
+                if (channel->mNumScalingKeys > 0) {
+                    glm::vec3 k = sampleAssimpVector(channel->mScalingKeys, channel->mNumScalingKeys, ticks);
+                    s[0][0] = k.x;
+                    s[1][1] = k.y;
+                    s[2][2] = k.z;
+                }
+                local = t * r * s;
+                break;
+            }
+        }
+        glm::mat4 world = parent * local;
+        worlds[node->mName.C_Str()] = world;
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+            evaluateNode(node->mChildren[i], world, animation, ticks);
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Uso: vat_bake entrada.fbx salida.vat [--fps 30]" << std::endl;
+        return 1;
+    }
+    std::string input = argv[1], output = argv[2];
+    float fps = 30.0f;
+    for (int i = 3; i < argc; i++)
+        if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = (float)std::atof(argv[++i]);
+    if (fps <= 0.0f)
+        fps = 30.0f;
+
+    // Mismo post-proceso que Model::import, así los UVs y el orden de vértices coinciden
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(input, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
+        return 1;
+    }
+
+    Baker baker(scene);
+    VatData data;
+    baker.writeTopology(data);
+    uint32_t vertices = baker.vertexCount();
+
+    // Un clip por animación; cada frame en [0, duración) para que el último enlace con el primero
+    struct Sample { const aiAnimation* animation; double ticks; };
+    std::vector<Sample> samples;
+    for (unsigned int a = 0; a < scene->mNumAnimations; a++) {
+        const aiAnimation* animation = scene->mAnimations[a];
+        double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+        double seconds = animation->mDuration / ticksPerSecond;
+        uint32_t frames = std::max<uint32_t>(1, (uint32_t)std::lround(seconds * fps));
+        VatClip clip;
+        std::strncpy(clip.name, animation->mName.length > 0 ? animation->mName.C_Str() : "clip", sizeof(clip.name) - 1);
+        clip.firstFrame = (uint32_t)samples.size();
+        clip.frameCount = frames;
+        clip.fps = fps;
+        data.clips.push_back(clip);
+        for (uint32_t f = 0; f < frames; f++)
+            samples.push_back({ animation, f / (double)fps * ticksPerSecond });
+    }
+    if (samples.empty()) {
+        std::cout << "AVISO: " << input << " no tiene animaciones; se hornea la pose del archivo" << std::endl;
+        VatClip clip;
+        std::strncpy(clip.name, "pose", sizeof(clip.name) - 1);
+        clip.frameCount = 1;
+        clip.fps = fps;
+        data.clips.push_back(clip);
+        samples.push_back({ nullptr, 0.0 });
+    }
+
+    // Primera pasada: todos los frames en float para conocer los límites
+    std::vector<glm::vec3> positions((size_t)vertices * samples.size()), normals(positions.size());
+    std::vector<glm::vec3> framePositions, frameNormals;
+    glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+    for (size_t f = 0; f < samples.size(); f++) {
+        baker.evaluate(samples[f].animation, samples[f].ticks, framePositions, frameNormals);
+        for (uint32_t v = 0; v < vertices; v++) {
+            boundsMin = glm::min(boundsMin, framePositions[v]);
+            boundsMax = glm::max(boundsMax, framePositions[v]);
+        }
+        std::copy(framePositions.begin(), framePositions.end(), positions.begin() + f * vertices);
+        std::copy(frameNormals.begin(), frameNormals.end(), normals.begin() + f * vertices);
+    }
+
+    VatHeader& h = data.header;
+    h.vertexCount = vertices;
+    h.indexCount = (uint32_t)data.indices.size();
+    h.frameCount = (uint32_t)samples.size();
+    h.clipCount = (uint32_t)data.clips.size();
+    h.submeshCount = (uint32_t)data.submeshes.size();
+    h.textureHeight = vatTextureHeight(vertices, h.frameCount);
+    for (int c = 0; c < 3; c++) {
+        h.boundsMin[c] = boundsMin[c];
+        h.boundsMax[c] = boundsMax[c];
+    }
+
+    // Segunda pasada: cuantizar
+    data.positions.assign(data.texelCount() * 4, 0);
+    data.normals.assign(data.texelCount() * 4, 0);
+    glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+    float maxError = 0.0f;
+    for (size_t i = 0; i < positions.size(); i++) {
+        glm::vec3 unit = glm::clamp((positions[i] - boundsMin) / extent, 0.0f, 1.0f);
+        for (int c = 0; c < 3; c++) {
+            uint16_t q = (uint16_t)std::lround(unit[c] * 65535.0f);
+            data.positions[i * 4 + c] = q;
+            data.normals[i * 4 + c] = (int8_t)std::lround(glm::clamp(normals[i][c], -1.0f, 1.0f) * 127.0f);
+            maxError = std::max(maxError, std::fabs(q / 65535.0f * extent[c] + boundsMin[c] - positions[i][c]));
+        }
+    }
+
+    if (!writeVatFile(output, data))
+        return 1;
+    std::printf("%s: %u vertices, %u clips, %u frames, textura %ux%u, %.1f KB, error max %.5f\n",
+                output.c_str(), vertices, h.clipCount, h.frameCount, h.textureWidth, h.textureHeight,
+                data.bytes() / 1024.0, maxError);
+    for (const VatClip& clip : data.clips)
+        std::printf("  clip '%s': %u frames a %.0f fps\n", clip.name, clip.frameCount, clip.fps);
+    return 0;
+}